@@ -0,0 +1,497 @@
+#pragma once
+
+#include "DynamicArray.h"
+#include "FixedSizeArray.h"
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+// The vectorized kernels rely on GCC vector extensions and function-level target attributes
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__)))
+#define ARRAY_KERNELS_X86
+#endif
+
+///
+/// Instruction sets, which can be used by ArrayKernels
+///
+enum class SimdLevel {
+  Scalar, ///< Plain loops, available everywhere
+  Sse2,   ///< 128-bit vectors, available on every x86-64 CPU
+  Avx2,   ///< 256-bit vectors, selected at runtime when the CPU supports them
+};
+
+///
+/// Vectorized reductions and searches over contiguous arrays of arithmetic values
+///
+/// Every function has a scalar version and, when compiled with GCC or Clang for x86,
+/// SSE2 and AVX2 versions. The best one supported by the CPU is picked at runtime.
+///
+/// All versions produce exactly the same results, including for floating point values.
+/// To achieve this, the reductions always use the same order of operations:
+///  - Arrays with less than `Lanes` elements are folded from left to right.
+///  - Otherwise lane `j` accumulates the elements at positions `j`, `j + Lanes`, `j + 2*Lanes`, ...
+///    of the largest prefix whose size is divisible by `Lanes`. The lanes are then combined
+///    pairwise as ((0,1),(2,3)),((4,5),(6,7)) and the remaining elements are folded from left to right.
+///
+/// Sums of integers wrap around, as if they were computed with unsigned arithmetic.
+/// min() and max() follow the semantics of `(a < b) ? a : b` and `(a > b) ? a : b`,
+/// which means that the result for arrays containing NaNs depends on their positions.
+///
+template <typename T>
+class ArrayKernels {
+  static_assert(std::is_arithmetic_v<T> && ! std::is_same_v<T, bool>, "ArrayKernels requires an arithmetic element type");
+
+public:
+  /// Number of independent accumulators used by the reductions
+  static constexpr size_t Lanes = 8;
+
+  /// Checks whether the functions can run with a given instruction set on this machine
+  static bool supports(SimdLevel level) noexcept
+  {
+    switch (level) {
+    case SimdLevel::Scalar:
+      return true;
+#if defined(ARRAY_KERNELS_X86)
+    case SimdLevel::Sse2:
+      return Vectorizable;
+    case SimdLevel::Avx2:
+      return Vectorizable && cpuSupportsAvx2();
+#endif
+    default:
+      return false;
+    }
+  }
+
+  /// The fastest instruction set which can be used on this machine
+  static SimdLevel bestLevel() noexcept
+  {
+    static const SimdLevel best =
+      supports(SimdLevel::Avx2) ? SimdLevel::Avx2 :
+      supports(SimdLevel::Sse2) ? SimdLevel::Sse2 :
+      SimdLevel::Scalar;
+
+    return best;
+  }
+
+  /// Sum of the elements in [data, data+size). Returns zero for an empty range.
+  static T sum(const T* data, size_t size, SimdLevel level = bestLevel())
+  {
+    if (size == 0)
+      return T();
+
+    if constexpr (std::is_integral_v<T>) {
+      using U = std::make_unsigned_t<T>;
+      return static_cast<T>(ArrayKernels<U>::reduce(reinterpret_cast<const U*>(data), size, Add(), level));
+    }
+    else {
+      return reduce(data, size, Add(), level);
+    }
+  }
+
+  /// Smallest element in [data, data+size)
+  /// @pre size > 0
+  static T min(const T* data, size_t size, SimdLevel level = bestLevel())
+  {
+    assert(size > 0);
+    return reduce(data, size, Min(), level);
+  }
+
+  /// Largest element in [data, data+size)
+  /// @pre size > 0
+  static T max(const T* data, size_t size, SimdLevel level = bestLevel())
+  {
+    assert(size > 0);
+    return reduce(data, size, Max(), level);
+  }
+
+  /// Number of elements in [data, data+size), which are equal to `value`
+  static size_t count(const T* data, size_t size, T value, SimdLevel level = bestLevel())
+  {
+#if defined(ARRAY_KERNELS_X86)
+    if constexpr (Vectorizable) {
+      if (level != SimdLevel::Scalar)
+        return runVectorized(level, [&](auto bytes) { return countVectorized<bytes>(data, size, value); });
+    }
+#endif
+    (void)level;
+    size_t result = 0;
+    for (size_t i = 0; i < size; ++i)
+      result += (data[i] == value);
+    return result;
+  }
+
+  /// Index of the first element in [data, data+size), which is equal to `value`,
+  /// or `size` if there is no such element
+  static size_t find(const T* data, size_t size, T value, SimdLevel level = bestLevel())
+  {
+#if defined(ARRAY_KERNELS_X86)
+    if constexpr (Vectorizable) {
+      if (level != SimdLevel::Scalar)
+        return runVectorized(level, [&](auto bytes) { return findVectorized<bytes>(data, size, value); });
+    }
+#endif
+    (void)level;
+    size_t i = 0;
+    while (i < size && ! (data[i] == value))
+      ++i;
+    return i;
+  }
+
+private:
+  template <typename> friend class ArrayKernels;
+
+  //
+  // The operations combine a value into an accumulator in place.
+  // They work both for scalars and for GCC vector types, so that
+  // the scalar and the vectorized code apply exactly the same operation to each lane.
+  //
+  struct Add {
+    template <typename V>
+    void operator()(V& acc, const V& x) const { acc = acc + x; }
+  };
+
+  struct Min {
+    template <typename V>
+    void operator()(V& acc, const V& x) const { acc = (acc < x) ? acc : x; }
+  };
+
+  struct Max {
+    template <typename V>
+    void operator()(V& acc, const V& x) const { acc = (acc > x) ? acc : x; }
+  };
+
+  /// Combines the lane accumulators and the elements after the last full block of `Lanes` elements
+  template <typename Op>
+  static T finish(T (&lanes)[Lanes], const T* data, size_t from, size_t size, Op op)
+  {
+    op(lanes[0], lanes[1]);
+    op(lanes[2], lanes[3]);
+    op(lanes[4], lanes[5]);
+    op(lanes[6], lanes[7]);
+    op(lanes[0], lanes[2]);
+    op(lanes[4], lanes[6]);
+    op(lanes[0], lanes[4]);
+
+    T result = lanes[0];
+    for (size_t i = from; i < size; ++i)
+      op(result, data[i]);
+
+    return result;
+  }
+
+  /// Folds a range which is too short to fill all lanes
+  template <typename Op>
+  static T foldLeft(const T* data, size_t size, Op op)
+  {
+    T result = data[0];
+    for (size_t i = 1; i < size; ++i)
+      op(result, data[i]);
+
+    return result;
+  }
+
+  /// Reduction with a given instruction set
+  /// @pre size > 0
+  template <typename Op>
+  static T reduce(const T* data, size_t size, Op op, SimdLevel level)
+  {
+    if (size < Lanes)
+      return foldLeft(data, size, op);
+
+#if defined(ARRAY_KERNELS_X86)
+    if constexpr (Vectorizable) {
+      if (level != SimdLevel::Scalar)
+        return runVectorized(level, [&](auto bytes) { return reduceVectorized<bytes>(data, size, op); });
+    }
+#endif
+    (void)level;
+    return reduceScalar(data, size, op);
+  }
+
+  /// Reference implementation of the lane-wise reduction
+  /// @pre size >= Lanes
+  template <typename Op>
+  static T reduceScalar(const T* data, size_t size, Op op)
+  {
+    T lanes[Lanes];
+    for (size_t j = 0; j < Lanes; ++j)
+      lanes[j] = data[j];
+
+    size_t i = Lanes;
+    for (; i + Lanes <= size; i += Lanes) {
+      for (size_t j = 0; j < Lanes; ++j)
+        op(lanes[j], data[i + j]);
+    }
+
+    return finish(lanes, data, i, size, op);
+  }
+
+#if defined(ARRAY_KERNELS_X86)
+  /// long double and other exotic types are only processed by the scalar code
+  static constexpr bool Vectorizable = sizeof(T) <= 8;
+
+  /// Width of the vector registers of SSE2
+  static constexpr size_t SseBytes = 16;
+
+  /// Width of the vector registers of AVX2
+  static constexpr size_t AvxBytes = 32;
+
+  ///
+  /// Vectors with a given width in bytes
+  ///
+  /// The same code is compiled for SSE2 and AVX2, depending on the function in which it is inlined.
+  /// The functions receive and return vectors through references, because passing them by value
+  /// between functions compiled for different instruction sets would use different ABIs.
+  ///
+  template <size_t Bytes>
+  struct Registers {
+    using Element = std::conditional_t<Vectorizable, T, double>;
+    typedef Element Vector __attribute__((vector_size(Bytes)));
+    using Mask = decltype(Vector() == Vector());
+
+    /// Number of elements in a single register
+    static constexpr size_t Width = Bytes / sizeof(Element);
+
+    __attribute__((always_inline)) static void load(Vector& result, const T* data)
+    {
+      std::memcpy(&result, data, sizeof(result));
+    }
+
+    /// Adding a scalar to a vector adds it to every lane, so this needs no lane-by-lane writes
+    __attribute__((always_inline)) static void broadcast(Vector& result, T value)
+    {
+      result = Vector{} + static_cast<Element>(value);
+    }
+
+    __attribute__((always_inline)) static bool any(const Mask& mask)
+    {
+      std::uint64_t words[sizeof(Mask) / sizeof(std::uint64_t)];
+      std::memcpy(words, &mask, sizeof(mask));
+
+      std::uint64_t result = 0;
+      for (std::uint64_t word : words)
+        result |= word;
+
+      return result != 0;
+    }
+  };
+
+  /// Number of bytes in a block of `Lanes` elements
+  static constexpr size_t LaneBytes = Lanes * sizeof(T);
+
+  /// Width of the registers, which hold the lanes, when the widest available registers have `Bytes` bytes
+  static constexpr size_t laneRegisterBytes(size_t bytes) noexcept
+  {
+    return bytes < LaneBytes ? bytes : LaneBytes;
+  }
+
+  static bool cpuSupportsAvx2() noexcept
+  {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+  }
+
+  /// Calls `f` from a function compiled for AVX2. `flatten` inlines `f` and everything it calls
+  /// here, whatever the inlining heuristics decide, so that the vectorized code is compiled
+  /// for AVX2 too. A call left out of line would run the kernel with SSE2 code.
+  template <typename F>
+  __attribute__((target("avx2"), flatten)) static auto runWithAvx2(F f)
+  {
+    return f();
+  }
+
+  /// Dispatches a vectorized function, which is parameterized by the width of the registers
+  template <typename F>
+  static auto runVectorized(SimdLevel level, F f)
+  {
+    if (level == SimdLevel::Avx2)
+      return runWithAvx2([&] { return f(std::integral_constant<size_t, AvxBytes>()); });
+    else
+      return f(std::integral_constant<size_t, SseBytes>());
+  }
+
+  /// @copydoc reduceScalar
+  /// The lanes are split into as many registers of `Bytes` bytes as needed.
+  template <size_t Bytes, typename Op>
+  __attribute__((always_inline)) static T reduceVectorized(const T* data, size_t size, Op op)
+  {
+    using R = Registers<laneRegisterBytes(Bytes)>;
+    constexpr size_t Count = Lanes / R::Width;
+
+    typename R::Vector acc[Count], block[Count];
+    for (size_t r = 0; r < Count; ++r)
+      R::load(acc[r], data + r * R::Width);
+
+    size_t i = Lanes;
+    for (; i + Lanes <= size; i += Lanes) {
+      for (size_t r = 0; r < Count; ++r) {
+        R::load(block[r], data + i + r * R::Width);
+        op(acc[r], block[r]);
+      }
+    }
+
+    T lanes[Lanes];
+    std::memcpy(lanes, acc, sizeof(lanes));
+
+    return finish(lanes, data, i, size, op);
+  }
+
+  /// Number of registers processed in each iteration by count() and find()
+  static constexpr size_t Unroll = 4;
+
+  template <size_t Bytes>
+  __attribute__((always_inline)) static size_t countVectorized(const T* data, size_t size, T value)
+  {
+    using R = Registers<Bytes>;
+    constexpr size_t Step = Unroll * R::Width;
+
+    // Comparisons produce -1 in each matching lane, so subtracting the masks counts the matches.
+    // The counters have the width of T and are flushed before they can overflow.
+    const size_t blocksBeforeOverflow =
+      (sizeof(T) >= sizeof(size_t)) ? SIZE_MAX : (size_t(1) << (8 * sizeof(T) - 1)) - 1;
+
+    typename R::Vector needle{}, block{};
+    R::broadcast(needle, value);
+    size_t result = 0;
+    size_t i = 0;
+
+    while (i + Step <= size) {
+      typename R::Mask counters[Unroll] = {};
+
+      for (size_t blocks = 0; blocks < blocksBeforeOverflow && i + Step <= size; ++blocks, i += Step) {
+        for (size_t r = 0; r < Unroll; ++r) {
+          R::load(block, data + i + r * R::Width);
+          counters[r] -= (block == needle);
+        }
+      }
+
+      for (size_t r = 0; r < Unroll; ++r) {
+        for (size_t j = 0; j < R::Width; ++j)
+          result += static_cast<size_t>(counters[r][j]);
+      }
+    }
+
+    for (; i < size; ++i)
+      result += (data[i] == value);
+
+    return result;
+  }
+
+  template <size_t Bytes>
+  __attribute__((always_inline)) static size_t findVectorized(const T* data, size_t size, T value)
+  {
+    using R = Registers<Bytes>;
+    constexpr size_t Step = Unroll * R::Width;
+
+    typename R::Vector needle{}, block{};
+    R::broadcast(needle, value);
+    size_t i = 0;
+
+    for (; i + Step <= size; i += Step) {
+      typename R::Mask matches = {};
+
+      for (size_t r = 0; r < Unroll; ++r) {
+        R::load(block, data + i + r * R::Width);
+        matches |= (block == needle);
+      }
+
+      if (R::any(matches))
+        break;
+    }
+
+    while (i < size && ! (data[i] == value))
+      ++i;
+
+    return i;
+  }
+#endif
+};
+
+/// @copydoc ArrayKernels::sum
+template <typename T>
+T sum(const FixedSizeArray<T>& arr)
+{
+  return ArrayKernels<T>::sum(arr.data(), arr.size());
+}
+
+/// @copydoc ArrayKernels::sum
+template <typename T>
+T sum(const DynamicArray<T>& arr)
+{
+  return ArrayKernels<T>::sum(arr.data(), arr.size());
+}
+
+/// Smallest element in the array
+/// @exception std::logic_error If the array is empty
+template <typename T>
+T minValue(const FixedSizeArray<T>& arr)
+{
+  if (arr.empty())
+    throw std::logic_error("Operation was performed on an empty array");
+
+  return ArrayKernels<T>::min(arr.data(), arr.size());
+}
+
+/// Smallest element in the array
+/// @exception DynamicArray<T>::EmptyArrayException If the array is empty
+template <typename T>
+T minValue(const DynamicArray<T>& arr)
+{
+  if (arr.size() == 0)
+    throw typename DynamicArray<T>::EmptyArrayException();
+
+  return ArrayKernels<T>::min(arr.data(), arr.size());
+}
+
+/// Largest element in the array
+/// @exception std::logic_error If the array is empty
+template <typename T>
+T maxValue(const FixedSizeArray<T>& arr)
+{
+  if (arr.empty())
+    throw std::logic_error("Operation was performed on an empty array");
+
+  return ArrayKernels<T>::max(arr.data(), arr.size());
+}
+
+/// Largest element in the array
+/// @exception DynamicArray<T>::EmptyArrayException If the array is empty
+template <typename T>
+T maxValue(const DynamicArray<T>& arr)
+{
+  if (arr.size() == 0)
+    throw typename DynamicArray<T>::EmptyArrayException();
+
+  return ArrayKernels<T>::max(arr.data(), arr.size());
+}
+
+/// Number of elements equal to `value`
+template <typename T>
+size_t count(const FixedSizeArray<T>& arr, const T& value)
+{
+  return ArrayKernels<T>::count(arr.data(), arr.size(), value);
+}
+
+/// Number of elements equal to `value`
+template <typename T>
+size_t count(const DynamicArray<T>& arr, const T& value)
+{
+  return ArrayKernels<T>::count(arr.data(), arr.size(), value);
+}
+
+/// Index of the first element equal to `value`, or size() if there is no such element
+template <typename T>
+size_t find(const FixedSizeArray<T>& arr, const T& value)
+{
+  return ArrayKernels<T>::find(arr.data(), arr.size(), value);
+}
+
+/// Index of the first element equal to `value`, or size() if there is no such element
+template <typename T>
+size_t find(const DynamicArray<T>& arr, const T& value)
+{
+  return ArrayKernels<T>::find(arr.data(), arr.size(), value);
+}
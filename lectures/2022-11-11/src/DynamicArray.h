@@ -121,6 +121,11 @@ public:
       return;
 
     size_t newCapacity = std::max(desiredCapacity, capacity() * 2);
+
+    // Huge buffers of trivial types can be enlarged by remapping their pages,
+    // which avoids the copy and does not hold two buffers at the same time.
+    if (m_data.growInPlace(newCapacity))
+      return;
     
     FixedSizeArray<T> buffer(newCapacity);
     buffer.fillFrom(m_data);
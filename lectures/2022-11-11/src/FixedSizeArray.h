@@ -1,10 +1,93 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
 template <typename T>
 class FixedSizeArray {
 	T* m_data = nullptr;
 	size_t m_size = 0;
 
+public:
+
+	/// Buffers of at least this many bytes are obtained directly from the OS
+	/// when the element type allows it (see usesMappedStorage()).
+	static constexpr size_t MappedStorageThreshold = 256 * 1024 * 1024;
+
+	///
+	/// Checks whether an array of `size` elements keeps its buffer in pages mapped with mmap()
+	///
+	/// This is only done on Linux and only for trivial element types. Their buffers can be
+	/// moved around with mremap() without calling constructors or assignment operators,
+	/// which allows growInPlace() to enlarge them without copying.
+	/// Smaller arrays and all other types use new[].
+	///
+	static constexpr bool usesMappedStorage(size_t size) noexcept
+	{
+#if defined(__linux__)
+		return std::is_trivial_v<T> && size != 0 && size >= MappedStorageThreshold / sizeof(T);
+#else
+		(void)size;
+		return false;
+#endif
+	}
+
+private:
+	/// Allocates a buffer for `size` elements
+	/// @exception std::bad_alloc if memory allocation fails
+	static T* allocate(size_t size)
+	{
+#if defined(__linux__)
+		if (usesMappedStorage(size)) {
+			if (size > SIZE_MAX / sizeof(T))
+				throw std::bad_alloc();
+
+			void* pages = mmap(nullptr, size * sizeof(T), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+			if (pages == MAP_FAILED)
+				throw std::bad_alloc();
+
+			adviseHugePages(pages, size);
+			return static_cast<T*>(pages);
+		}
+#endif
+		return new T[size];
+	}
+
+	/// Releases a buffer obtained from allocate(size)
+	static void deallocate(T* data, size_t size) noexcept
+	{
+#if defined(__linux__)
+		if (usesMappedStorage(size)) {
+			munmap(data, size * sizeof(T));
+			return;
+		}
+#endif
+		(void)size;
+		delete[] data;
+	}
+
+#if defined(__linux__)
+	/// Asks the kernel to back a mapped buffer with transparent huge pages, which reduces TLB misses.
+	/// This is only a hint, so failures are ignored.
+	static void adviseHugePages(void* pages, size_t size) noexcept
+	{
+#if defined(MADV_HUGEPAGE)
+		madvise(pages, size * sizeof(T), MADV_HUGEPAGE);
+#else
+		(void)pages;
+		(void)size;
+#endif
+	}
+#endif
+
 public:
 
 	/// Constructs an empty array
@@ -15,11 +98,47 @@ public:
 	FixedSizeArray(size_t size)
 	{
 		if (size != 0) {
-			m_data = new T[size];
+			m_data = allocate(size);
 			m_size = size;
 		}
 	}
 
+	///
+	/// Changes the size of the array without copying its elements, if possible
+	///
+	/// This only works when both the current and the new size use mapped storage
+	/// (see usesMappedStorage()). The kernel then moves the existing pages with mremap(),
+	/// so the address of the buffer may change, but no elements are copied.
+	/// The first min(size(), newSize) elements keep their values and
+	/// any new elements are zero-initialized.
+	/// 
+	/// @return true if the array was resized, false if the caller has to allocate a new buffer and copy
+	/// @exception std::bad_alloc if the kernel cannot provide the memory. The array remains unchanged.
+	///
+	bool growInPlace(size_t newSize)
+	{
+#if defined(__linux__)
+		if ( ! usesMappedStorage(m_size) || ! usesMappedStorage(newSize))
+			return false;
+
+		if (newSize > SIZE_MAX / sizeof(T))
+			throw std::bad_alloc();
+
+		void* pages = mremap(m_data, m_size * sizeof(T), newSize * sizeof(T), MREMAP_MAYMOVE);
+
+		if (pages == MAP_FAILED)
+			throw std::bad_alloc();
+
+		adviseHugePages(pages, newSize);
+		m_data = static_cast<T*>(pages);
+		m_size = newSize;
+		return true;
+#else
+		(void)newSize;
+		return false;
+#endif
+	}
+
 	///
 	/// Copies the values from another array into the current object
 	/// 
@@ -65,7 +184,7 @@ public:
 
 	~FixedSizeArray() noexcept
 	{
-		delete [] m_data;
+		deallocate(m_data, m_size);
 	}
 
 	size_t size() const noexcept
@@ -0,0 +1,230 @@
+#pragma once
+
+#include "FixedSizeArray.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+///
+/// A sequence of characters, optimized for editing around a cursor
+///
+/// The characters are stored in a FixedSizeArray, which has an unused region
+/// (the gap) at the position of the cursor:
+///
+///     [ text before the cursor | gap | text after the cursor ]
+///
+/// Inserting and erasing at the cursor only changes the bounds of the gap and is O(1)
+/// (amortized, in the case of insertion). Moving the cursor by a distance `d`
+/// moves `d` characters from one side of the gap to the other.
+///
+template <typename CharT = char>
+class GapBuffer {
+  FixedSizeArray<CharT> m_buffer;
+  size_t m_gapBegin = 0;
+  size_t m_gapEnd = 0;
+
+public:
+  using View = std::basic_string_view<CharT>;
+  using String = std::basic_string<CharT>;
+
+  /// Creates an empty buffer
+  GapBuffer() = default;
+
+  /// Creates a buffer with a given text. The cursor is placed at the end of the text.
+  /// @exception std::bad_alloc if memory allocation fails
+  explicit GapBuffer(View text)
+  {
+    insert(text);
+  }
+
+  /// Number of characters in the buffer
+  size_t size() const noexcept
+  {
+    return m_buffer.size() - gapSize();
+  }
+
+  bool empty() const noexcept
+  {
+    return size() == 0;
+  }
+
+  /// Number of characters the buffer can hold before it has to grow
+  size_t capacity() const noexcept
+  {
+    return m_buffer.size();
+  }
+
+  /// Position of the cursor, which is in [0, size()]
+  size_t cursor() const noexcept
+  {
+    return m_gapBegin;
+  }
+
+  ///
+  /// Moves the cursor to a given position
+  ///
+  /// The characters between the old and the new position are moved
+  /// to the other side of the gap.
+  ///
+  /// @exception std::out_of_range if position > size()
+  ///
+  void moveCursor(size_t position)
+  {
+    if (position > size())
+      throw std::out_of_range("The cursor position is out of the bounds of the buffer");
+
+    // Without a gap the text does not move, and the copies below would overlap
+    if (gapSize() == 0) {
+      m_gapBegin = m_gapEnd = position;
+      return;
+    }
+
+    CharT* data = m_buffer.data();
+
+    if (position < m_gapBegin) {
+      const size_t distance = m_gapBegin - position;
+      std::copy_backward(data + position, data + m_gapBegin, data + m_gapEnd);
+      m_gapBegin -= distance;
+      m_gapEnd -= distance;
+    }
+    else if (position > m_gapBegin) {
+      const size_t distance = position - m_gapBegin;
+      std::copy(data + m_gapEnd, data + m_gapEnd + distance, data + m_gapBegin);
+      m_gapBegin += distance;
+      m_gapEnd += distance;
+    }
+  }
+
+  /// Inserts a character at the cursor and places the cursor after it
+  /// @exception std::bad_alloc if memory allocation fails. The buffer remains unchanged.
+  void insert(CharT c)
+  {
+    reserveGap(1);
+    m_buffer[m_gapBegin++] = c;
+  }
+
+  /// Inserts a text at the cursor and places the cursor after it
+  /// @exception std::bad_alloc if memory allocation fails. The buffer remains unchanged.
+  void insert(View text)
+  {
+    reserveGap(text.size());
+    std::copy(text.begin(), text.end(), m_buffer.data() + m_gapBegin);
+    m_gapBegin += text.size();
+  }
+
+  /// Removes `count` characters before the cursor, like the Backspace key
+  /// @exception std::out_of_range if there are less than `count` characters before the cursor
+  void eraseBefore(size_t count = 1)
+  {
+    if (count > m_gapBegin)
+      throw std::out_of_range("Not enough characters before the cursor");
+
+    m_gapBegin -= count;
+  }
+
+  /// Removes `count` characters after the cursor, like the Delete key
+  /// @exception std::out_of_range if there are less than `count` characters after the cursor
+  void eraseAfter(size_t count = 1)
+  {
+    if (count > m_buffer.size() - m_gapEnd)
+      throw std::out_of_range("Not enough characters after the cursor");
+
+    m_gapEnd += count;
+  }
+
+  /// Retrieve the character at a position in the text
+  /// @exception std::out_of_range If the index is out of the bounds of the text
+  CharT& at(size_t index)
+  {
+    if (index >= size())
+      throw std::out_of_range("index is out of the bounds of the buffer");
+
+    return m_buffer[physicalIndex(index)];
+  }
+
+  /// Retrieve the character at a position in the text
+  /// @exception std::out_of_range If the index is out of the bounds of the text
+  const CharT& at(size_t index) const
+  {
+    if (index >= size())
+      throw std::out_of_range("index is out of the bounds of the buffer");
+
+    return m_buffer[physicalIndex(index)];
+  }
+
+  /// Retrieve the character at a position in the text
+  CharT& operator[](size_t index) noexcept
+  {
+    return m_buffer[physicalIndex(index)];
+  }
+
+  /// Retrieve the character at a position in the text
+  const CharT& operator[](size_t index) const noexcept
+  {
+    return m_buffer[physicalIndex(index)];
+  }
+
+  /// The text before the cursor. Invalidated by any modification of the buffer.
+  View before() const noexcept
+  {
+    return View(m_buffer.data(), m_gapBegin);
+  }
+
+  /// The text after the cursor. Invalidated by any modification of the buffer.
+  View after() const noexcept
+  {
+    return View(m_buffer.data() + m_gapEnd, m_buffer.size() - m_gapEnd);
+  }
+
+  ///
+  /// The whole text as a single contiguous view
+  ///
+  /// Since the cursor is always at the gap, this moves the cursor to the end of the text.
+  /// The view is invalidated by any modification of the buffer.
+  ///
+  View view()
+  {
+    moveCursor(size());
+    return before();
+  }
+
+  /// A copy of the whole text
+  String toString() const
+  {
+    String result;
+    result.reserve(size());
+    result.append(before());
+    result.append(after());
+    return result;
+  }
+
+private:
+  size_t gapSize() const noexcept
+  {
+    return m_gapEnd - m_gapBegin;
+  }
+
+  size_t physicalIndex(size_t index) const noexcept
+  {
+    return index < m_gapBegin ? index : index + gapSize();
+  }
+
+  /// Ensures the gap can hold at least `count` characters
+  void reserveGap(size_t count)
+  {
+    if (count <= gapSize())
+      return;
+
+    const size_t afterSize = m_buffer.size() - m_gapEnd;
+    const size_t newCapacity = std::max({ size() + count, m_buffer.size() * 2, size_t(16) });
+
+    FixedSizeArray<CharT> buffer(newCapacity);
+    std::copy(m_buffer.data(), m_buffer.data() + m_gapBegin, buffer.data());
+    std::copy(m_buffer.data() + m_gapEnd, m_buffer.data() + m_buffer.size(), buffer.data() + newCapacity - afterSize);
+
+    m_buffer.swap(buffer);
+    m_gapEnd = newCapacity - afterSize;
+  }
+};
@@ -0,0 +1,246 @@
+#pragma once
+
+#include "DynamicArray.h"
+#include "FixedSizeArray.h"
+
+#include <stdexcept>
+#include <utility>
+
+///
+/// A view of a contiguous sequence of elements, which does not own them
+///
+template <typename T>
+class RowSpan {
+  T* m_data = nullptr;
+  size_t m_size = 0;
+
+public:
+  RowSpan() = default;
+
+  RowSpan(T* data, size_t size) noexcept
+    : m_data(data), m_size(size)
+  {}
+
+  size_t size() const noexcept
+  {
+    return m_size;
+  }
+
+  bool empty() const noexcept
+  {
+    return m_size == 0;
+  }
+
+  T* data() const noexcept
+  {
+    return m_data;
+  }
+
+  T* begin() const noexcept
+  {
+    return m_data;
+  }
+
+  T* end() const noexcept
+  {
+    return m_data + m_size;
+  }
+
+  T& operator[](size_t index) const noexcept
+  {
+    return m_data[index];
+  }
+};
+
+///
+/// An array of rows with different lengths, stored in compressed sparse row (CSR) format
+///
+/// The elements of all rows are stored back to back in a single FixedSizeArray.
+/// A second array stores the offset at which each row begins, so that
+/// row i occupies [offset[i], offset[i + 1]). Compared to an array of DynamicArray
+/// objects this needs two allocations in total instead of one per row and scanning
+/// all rows reads memory sequentially.
+///
+/// The number and lengths of the rows are fixed. Use a JaggedArrayBuilder to create the array.
+///
+template <typename T>
+class JaggedArray {
+  FixedSizeArray<T> m_values;
+  FixedSizeArray<size_t> m_offsets;
+
+public:
+  /// Constructs an array with no rows
+  JaggedArray() = default;
+
+  /// Constructs an array from its values and the offsets of its rows
+  /// @exception std::invalid_argument if the offsets are not ascending or do not match the values
+  JaggedArray(FixedSizeArray<T>&& values, FixedSizeArray<size_t>&& offsets)
+    : m_values(std::move(values)), m_offsets(std::move(offsets))
+  {
+    if (m_offsets.empty() ? ! m_values.empty() : (m_offsets[0] != 0 || m_offsets[m_offsets.size() - 1] != m_values.size()))
+      throw std::invalid_argument("The row offsets do not match the values");
+
+    for (size_t i = 1; i < m_offsets.size(); ++i) {
+      if (m_offsets[i] < m_offsets[i - 1])
+        throw std::invalid_argument("The row offsets are not ascending");
+    }
+  }
+
+  /// Number of rows
+  size_t rowCount() const noexcept
+  {
+    return m_offsets.empty() ? 0 : m_offsets.size() - 1;
+  }
+
+  /// Total number of elements in all rows
+  size_t size() const noexcept
+  {
+    return m_values.size();
+  }
+
+  bool empty() const noexcept
+  {
+    return rowCount() == 0;
+  }
+
+  /// Number of elements in a row
+  size_t rowSize(size_t row) const noexcept
+  {
+    return m_offsets[row + 1] - m_offsets[row];
+  }
+
+  /// The elements of a row
+  RowSpan<T> operator[](size_t row) noexcept
+  {
+    return RowSpan<T>(m_values.data() + m_offsets[row], rowSize(row));
+  }
+
+  /// The elements of a row
+  RowSpan<const T> operator[](size_t row) const noexcept
+  {
+    return RowSpan<const T>(m_values.data() + m_offsets[row], rowSize(row));
+  }
+
+  /// The elements of a row
+  /// @exception std::out_of_range If the index is out of the bounds of the array
+  RowSpan<T> at(size_t row)
+  {
+    if (row >= rowCount())
+      throw std::out_of_range("row is out of the bounds of the array");
+
+    return (*this)[row];
+  }
+
+  /// The elements of a row
+  /// @exception std::out_of_range If the index is out of the bounds of the array
+  RowSpan<const T> at(size_t row) const
+  {
+    if (row >= rowCount())
+      throw std::out_of_range("row is out of the bounds of the array");
+
+    return (*this)[row];
+  }
+
+  /// The elements of all rows, one after another
+  RowSpan<T> values() noexcept
+  {
+    return RowSpan<T>(m_values.data(), m_values.size());
+  }
+
+  /// The elements of all rows, one after another
+  RowSpan<const T> values() const noexcept
+  {
+    return RowSpan<const T>(m_values.data(), m_values.size());
+  }
+
+  /// Quickly swaps the contents of this object with that of another
+  void swap(JaggedArray& other) noexcept
+  {
+    m_values.swap(other.m_values);
+    m_offsets.swap(other.m_offsets);
+  }
+};
+
+///
+/// Creates a JaggedArray by appending rows one after another
+///
+/// While building, the values and offsets are kept in DynamicArray objects, which may
+/// have spare capacity. finalize() moves them into exactly sized arrays.
+///
+template <typename T>
+class JaggedArrayBuilder {
+  DynamicArray<T> m_values;
+  DynamicArray<size_t> m_offsets;
+
+public:
+  JaggedArrayBuilder() = default;
+
+  /// Reserves space for a given number of rows and elements
+  /// @exception std::bad_alloc Memory allocation failed
+  void reserve(size_t rows, size_t values)
+  {
+    m_offsets.reserve(rows + 1);
+    m_values.reserve(values);
+  }
+
+  /// Number of rows appended so far
+  size_t rowCount() const noexcept
+  {
+    return m_offsets.size();
+  }
+
+  /// Starts a new, empty row
+  /// @exception std::bad_alloc Memory allocation failed
+  void appendRow()
+  {
+    m_offsets.push_back(m_values.size());
+  }
+
+  /// Appends a row with the elements in [first, last)
+  /// @exception std::bad_alloc Memory allocation failed
+  template <typename Iterator>
+  void appendRow(Iterator first, Iterator last)
+  {
+    appendRow();
+    for (; first != last; ++first)
+      m_values.push_back(*first);
+  }
+
+  /// Appends a value to the last row
+  /// @exception std::logic_error if no row has been started yet
+  /// @exception std::bad_alloc Memory allocation failed
+  void push_back(const T& value)
+  {
+    if (m_offsets.size() == 0)
+      throw std::logic_error("No row has been started");
+
+    m_values.push_back(value);
+  }
+
+  ///
+  /// Moves the rows appended so far into a JaggedArray, which uses no spare memory
+  ///
+  /// The builder is empty afterwards and can be reused.
+  /// @exception std::bad_alloc Memory allocation failed. The builder remains unchanged.
+  ///
+  JaggedArray<T> finalize()
+  {
+    const size_t rows = m_offsets.size();
+    FixedSizeArray<T> values(m_values.size());
+    FixedSizeArray<size_t> offsets(rows == 0 ? 0 : rows + 1);
+
+    for (size_t i = 0; i < m_values.size(); ++i)
+      values[i] = std::move(m_values[i]);
+
+    for (size_t i = 0; i < rows; ++i)
+      offsets[i] = m_offsets[i];
+
+    if (rows > 0)
+      offsets[rows] = m_values.size();
+
+    m_values = DynamicArray<T>();
+    m_offsets = DynamicArray<size_t>();
+
+    return JaggedArray<T>(std::move(values), std::move(offsets));
+  }
+};
@@ -0,0 +1,249 @@
+#pragma once
+
+#include "FixedSizeArray.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+//
+// Parallel algorithms over FixedSizeArray and DynamicArray objects.
+// Any other type, which provides data() and size(), can also be used.
+//
+// The arrays are split into contiguous chunks, which are processed by the threads
+// of a ThreadPool. Chunk boundaries are aligned to cache lines, so that no two
+// threads write to the same cache line.
+//
+
+///
+/// Splits the elements of a contiguous buffer into chunks for parallel processing
+///
+template <typename T>
+class ParallelChunks {
+  size_t m_size = 0;
+  size_t m_firstBoundary = 0;
+  size_t m_chunkSize = 0;
+  size_t m_count = 0;
+
+public:
+  /// Assumed size of a cache line in bytes
+  static constexpr size_t CacheLineBytes = 64;
+
+  /// Chunks are not made smaller than this, because the cost of scheduling would dominate
+  static constexpr size_t MinimalChunkBytes = 16 * 1024;
+
+  /// Each thread gets this many chunks on average, which balances uneven workloads
+  static constexpr size_t ChunksPerThread = 4;
+
+  ParallelChunks(const T* data, size_t size, size_t threadCount)
+    : m_size(size)
+  {
+    const size_t elementsPerLine = (sizeof(T) < CacheLineBytes) ? CacheLineBytes / sizeof(T) : 1;
+
+    // The first chunk is extended up to a cache line boundary,
+    // which aligns the boundaries of all other chunks.
+    if (CacheLineBytes % sizeof(T) == 0) {
+      const size_t misalignment = reinterpret_cast<std::uintptr_t>(data) % CacheLineBytes;
+      m_firstBoundary = (misalignment % sizeof(T) == 0)
+        ? std::min(size, ((CacheLineBytes - misalignment) % CacheLineBytes) / sizeof(T))
+        : 0;
+    }
+
+    const size_t minimal = std::max<size_t>(1, MinimalChunkBytes / sizeof(T));
+    const size_t balanced = size / (threadCount * ChunksPerThread);
+    const size_t chunkSize = std::max(minimal, balanced);
+    m_chunkSize = (chunkSize + elementsPerLine - 1) / elementsPerLine * elementsPerLine;
+
+    const size_t rest = size - m_firstBoundary;
+    m_count = std::max<size_t>(1, (rest + m_chunkSize - 1) / m_chunkSize);
+  }
+
+  /// Number of chunks
+  size_t count() const noexcept
+  {
+    return m_count;
+  }
+
+  /// Index of the first element of a chunk
+  size_t begin(size_t chunk) const noexcept
+  {
+    return (chunk == 0) ? 0 : std::min(m_size, m_firstBoundary + chunk * m_chunkSize);
+  }
+
+  /// Index after the last element of a chunk
+  size_t end(size_t chunk) const noexcept
+  {
+    return begin(chunk + 1);
+  }
+};
+
+///
+/// Calls f(element) for each element of an array
+///
+/// Calls for different elements may run concurrently and in any order.
+///
+template <typename Array, typename F>
+void parallelFor(Array& arr, F f, ThreadPool& pool = ThreadPool::shared())
+{
+  auto* data = arr.data();
+  ParallelChunks chunks(data, arr.size(), pool.threadCount());
+
+  pool.run(chunks.count(), [&](size_t chunk) {
+    for (size_t i = chunks.begin(chunk); i < chunks.end(chunk); ++i)
+      f(data[i]);
+  });
+}
+
+///
+/// Stores f(in[i]) in out[i] for each element of `in`
+///
+/// `in` and `out` may be the same array.
+/// @exception std::invalid_argument if `out` is smaller than `in`
+///
+template <typename InputArray, typename OutputArray, typename F>
+void parallelTransform(const InputArray& in, OutputArray& out, F f, ThreadPool& pool = ThreadPool::shared())
+{
+  if (out.size() < in.size())
+    throw std::invalid_argument("The output array is smaller than the input");
+
+  const auto* source = in.data();
+  auto* target = out.data();
+  ParallelChunks chunks(target, in.size(), pool.threadCount());
+
+  pool.run(chunks.count(), [&](size_t chunk) {
+    for (size_t i = chunks.begin(chunk); i < chunks.end(chunk); ++i)
+      target[i] = f(source[i]);
+  });
+}
+
+///
+/// Combines all elements of an array with a binary operation
+///
+/// `op` must be associative. Each chunk is reduced separately and the results
+/// are combined from left to right, starting with `init`. For floating point values
+/// the result may differ from that of a sequential loop and depends on the number of threads.
+///
+template <typename Array, typename T, typename Op>
+T parallelReduce(const Array& arr, T init, Op op, ThreadPool& pool = ThreadPool::shared())
+{
+  const auto* data = arr.data();
+  ParallelChunks chunks(data, arr.size(), pool.threadCount());
+
+  if (arr.size() == 0)
+    return init;
+
+  FixedSizeArray<T> partial(chunks.count());
+
+  pool.run(chunks.count(), [&](size_t chunk) {
+    const size_t begin = chunks.begin(chunk);
+    const size_t end = chunks.end(chunk);
+
+    T result = data[begin];
+    for (size_t i = begin + 1; i < end; ++i)
+      result = op(result, data[i]);
+
+    partial[chunk] = result;
+  });
+
+  for (size_t chunk = 0; chunk < chunks.count(); ++chunk)
+    init = op(init, partial[chunk]);
+
+  return init;
+}
+
+///
+/// Computes out[i] = in[0] op in[1] op ... op in[i] for each element of `in`
+///
+/// `op` must be associative. `in` and `out` may be the same array.
+/// The array is processed twice: first each chunk is reduced, then each chunk
+/// is scanned, starting from the combined result of all chunks before it.
+/// @exception std::invalid_argument if `out` is smaller than `in`
+///
+template <typename InputArray, typename OutputArray, typename Op>
+void parallelInclusiveScan(const InputArray& in, OutputArray& out, Op op, ThreadPool& pool = ThreadPool::shared())
+{
+  if (out.size() < in.size())
+    throw std::invalid_argument("The output array is smaller than the input");
+
+  const auto* source = in.data();
+  auto* target = out.data();
+  using T = std::remove_reference_t<decltype(*target)>;
+
+  ParallelChunks chunks(target, in.size(), pool.threadCount());
+
+  if (in.size() == 0)
+    return;
+
+  // carry[k] is the combined result of all chunks before chunk k
+  FixedSizeArray<T> carry(chunks.count());
+
+  pool.run(chunks.count() - 1, [&](size_t chunk) {
+    T result = source[chunks.begin(chunk)];
+    for (size_t i = chunks.begin(chunk) + 1; i < chunks.end(chunk); ++i)
+      result = op(result, source[i]);
+
+    carry[chunk + 1] = result;
+  });
+
+  for (size_t chunk = 2; chunk < chunks.count(); ++chunk)
+    carry[chunk] = op(carry[chunk - 1], carry[chunk]);
+
+  pool.run(chunks.count(), [&](size_t chunk) {
+    size_t i = chunks.begin(chunk);
+    T result = (chunk == 0) ? source[i] : op(carry[chunk], source[i]);
+    target[i] = result;
+
+    for (++i; i < chunks.end(chunk); ++i) {
+      result = op(result, source[i]);
+      target[i] = result;
+    }
+  });
+}
+
+///
+/// Computes out[i] = init op in[0] op ... op in[i-1] for each element of `in`
+///
+/// `op` must be associative. `in` and `out` may be the same array.
+/// @exception std::invalid_argument if `out` is smaller than `in`
+///
+template <typename InputArray, typename OutputArray, typename T, typename Op>
+void parallelExclusiveScan(const InputArray& in, OutputArray& out, T init, Op op, ThreadPool& pool = ThreadPool::shared())
+{
+  if (out.size() < in.size())
+    throw std::invalid_argument("The output array is smaller than the input");
+
+  const auto* source = in.data();
+  auto* target = out.data();
+
+  ParallelChunks chunks(target, in.size(), pool.threadCount());
+
+  if (in.size() == 0)
+    return;
+
+  // carry[k] is the combined result of init and all chunks before chunk k
+  FixedSizeArray<T> carry(chunks.count());
+  carry[0] = init;
+
+  pool.run(chunks.count() - 1, [&](size_t chunk) {
+    T result = source[chunks.begin(chunk)];
+    for (size_t i = chunks.begin(chunk) + 1; i < chunks.end(chunk); ++i)
+      result = op(result, source[i]);
+
+    carry[chunk + 1] = result;
+  });
+
+  for (size_t chunk = 1; chunk < chunks.count(); ++chunk)
+    carry[chunk] = op(carry[chunk - 1], carry[chunk]);
+
+  pool.run(chunks.count(), [&](size_t chunk) {
+    T result = carry[chunk];
+
+    for (size_t i = chunks.begin(chunk); i < chunks.end(chunk); ++i) {
+      T value = source[i]; // read before writing, in case in and out are the same array
+      target[i] = result;
+      result = op(result, value);
+    }
+  });
+}
@@ -0,0 +1,230 @@
+#pragma once
+
+#include "FixedSizeArray.h"
+
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+//
+// Bounded lock-free queues, which store their elements in a FixedSizeArray.
+//
+// The capacity is rounded up to a power of two, so that positions can be mapped
+// to slots with a mask. The positions grow monotonically and are never reset.
+// Indices written by different threads are placed in separate cache lines,
+// so that producers and consumers do not invalidate each other's caches needlessly.
+// Since this makes the queues themselves aligned to cache lines, nothing else
+// shares a line with the last group of indices either.
+//
+// The element type must be default constructible and move assignable.
+// MpmcQueue additionally requires a move assignment, which does not throw.
+//
+
+/// Assumed size of a cache line in bytes
+constexpr size_t RingQueueCacheLine = 64;
+
+/// Rounds a queue capacity up to a power of two
+/// @exception std::invalid_argument if capacity is zero or too large
+inline size_t ringQueueCapacity(size_t capacity)
+{
+  if (capacity == 0 || capacity > (SIZE_MAX >> 1) + 1)
+    throw std::invalid_argument("Invalid queue capacity");
+
+  size_t result = 1;
+  while (result < capacity)
+    result <<= 1;
+
+  return result;
+}
+
+///
+/// Queue for exactly one producer and one consumer thread
+///
+/// Each side keeps a cached copy of the other side's index and only reloads it
+/// when the queue looks full (for the producer) or empty (for the consumer).
+///
+template <typename T>
+class SpscQueue {
+  FixedSizeArray<T> m_slots;
+  const size_t m_mask;
+
+  /// Position of the next element to pop. Written only by the consumer.
+  alignas(RingQueueCacheLine) std::atomic<size_t> m_head{0};
+  /// The consumer's copy of m_tail
+  size_t m_cachedTail = 0;
+
+  /// Position of the next element to push. Written only by the producer.
+  alignas(RingQueueCacheLine) std::atomic<size_t> m_tail{0};
+  /// The producer's copy of m_head
+  size_t m_cachedHead = 0;
+
+public:
+  /// Creates a queue, which can hold at least `capacity` elements
+  /// @exception std::invalid_argument if capacity is zero or too large
+  /// @exception std::bad_alloc if memory allocation fails
+  explicit SpscQueue(size_t capacity)
+    : m_slots(ringQueueCapacity(capacity)), m_mask(m_slots.size() - 1)
+  {}
+
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  /// Maximal number of elements in the queue
+  size_t capacity() const noexcept
+  {
+    return m_slots.size();
+  }
+
+  /// Appends a value to the queue. May only be called by the producer thread.
+  /// @return false if the queue is full
+  template <typename U>
+  bool tryPush(U&& value)
+  {
+    const size_t tail = m_tail.load(std::memory_order_relaxed);
+
+    if (tail - m_cachedHead == capacity()) {
+      m_cachedHead = m_head.load(std::memory_order_acquire);
+      if (tail - m_cachedHead == capacity())
+        return false;
+    }
+
+    m_slots[tail & m_mask] = std::forward<U>(value);
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Removes the first value from the queue and stores it in `result`.
+  /// May only be called by the consumer thread.
+  /// @return false if the queue is empty
+  bool tryPop(T& result)
+  {
+    const size_t head = m_head.load(std::memory_order_relaxed);
+
+    if (head == m_cachedTail) {
+      m_cachedTail = m_tail.load(std::memory_order_acquire);
+      if (head == m_cachedTail)
+        return false;
+    }
+
+    result = std::move(m_slots[head & m_mask]);
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+};
+
+///
+/// Queue for any number of producer and consumer threads
+///
+/// Each slot has a sequence number, which tells whether it is ready to be written
+/// (sequence == position) or read (sequence == position + 1) at a given position.
+/// Threads claim positions with a compare-and-swap on the shared indices.
+/// A claimed position cannot be given back, so the values are only moved in
+/// and out of the slots after the claim, which must not throw.
+///
+template <typename T>
+class MpmcQueue {
+  static_assert(std::is_nothrow_move_assignable_v<T>, "MpmcQueue requires a nothrow move assignment");
+
+  struct Slot {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+  FixedSizeArray<Slot> m_slots;
+  const size_t m_mask;
+
+  /// Position of the next element to push
+  alignas(RingQueueCacheLine) std::atomic<size_t> m_enqueuePosition{0};
+
+  /// Position of the next element to pop
+  alignas(RingQueueCacheLine) std::atomic<size_t> m_dequeuePosition{0};
+
+public:
+  /// Creates a queue, which can hold at least `capacity` elements
+  /// @exception std::invalid_argument if capacity is zero or too large
+  /// @exception std::bad_alloc if memory allocation fails
+  explicit MpmcQueue(size_t capacity)
+    : m_slots(ringQueueCapacity(capacity)), m_mask(m_slots.size() - 1)
+  {
+    for (size_t i = 0; i < m_slots.size(); ++i)
+      m_slots[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  MpmcQueue(const MpmcQueue&) = delete;
+  MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+  /// Maximal number of elements in the queue
+  size_t capacity() const noexcept
+  {
+    return m_slots.size();
+  }
+
+  /// Appends a copy of a value to the queue
+  /// @return false if the queue is full
+  /// @exception anything thrown by the copy constructor of T; the queue is not changed then
+  bool tryPush(const T& value)
+  {
+    T copy(value);
+    return tryPush(std::move(copy));
+  }
+
+  /// Appends a value to the queue
+  /// @return false if the queue is full
+  bool tryPush(T&& value) noexcept
+  {
+    size_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+    Slot* slot;
+
+    for (;;) {
+      slot = &m_slots[position & m_mask];
+      const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+      const std::intptr_t difference = static_cast<std::intptr_t>(sequence - position);
+
+      if (difference == 0) {
+        if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+          break;
+      }
+      else if (difference < 0) {
+        return false; // The slot still holds a value from the previous lap
+      }
+      else {
+        position = m_enqueuePosition.load(std::memory_order_relaxed);
+      }
+    }
+
+    slot->value = std::move(value);
+    slot->sequence.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Removes the first value from the queue and stores it in `result`
+  /// @return false if the queue is empty
+  bool tryPop(T& result) noexcept
+  {
+    size_t position = m_dequeuePosition.load(std::memory_order_relaxed);
+    Slot* slot;
+
+    for (;;) {
+      slot = &m_slots[position & m_mask];
+      const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+      const std::intptr_t difference = static_cast<std::intptr_t>(sequence - (position + 1));
+
+      if (difference == 0) {
+        if (m_dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+          break;
+      }
+      else if (difference < 0) {
+        return false; // Nothing has been written to the slot yet
+      }
+      else {
+        position = m_dequeuePosition.load(std::memory_order_relaxed);
+      }
+    }
+
+    result = std::move(slot->value);
+    slot->sequence.store(position + m_mask + 1, std::memory_order_release);
+    return true;
+  }
+};
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+///
+/// A fixed set of worker threads, which execute batches of tasks
+///
+/// The threads are created once and reused, so running a batch only costs
+/// waking them up. The thread calling run() also executes tasks, so a pool
+/// with N threads creates N-1 workers.
+///
+class ThreadPool {
+  std::vector<std::thread> m_workers;
+
+  /// Serializes calls to run() from different threads
+  std::mutex m_runMutex;
+
+  /// Protects the state of the current batch
+  std::mutex m_mutex;
+  std::condition_variable m_wakeUp;
+  std::condition_variable m_finished;
+
+  const std::function<void(size_t)>* m_task = nullptr;
+  size_t m_taskCount = 0;
+  std::atomic<size_t> m_nextTask{0};
+  size_t m_busyWorkers = 0;
+  size_t m_generation = 0;
+  bool m_stopping = false;
+  std::exception_ptr m_error;
+
+public:
+  /// Creates a pool, in which `threadCount` threads (including the caller of run()) execute tasks
+  /// @exception std::system_error if a thread cannot be started
+  explicit ThreadPool(size_t threadCount = defaultThreadCount())
+  {
+    try {
+      for (size_t i = 1; i < threadCount; ++i)
+        m_workers.emplace_back([this] { workerLoop(); });
+    }
+    catch (...) {
+      stop();
+      throw;
+    }
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  ~ThreadPool()
+  {
+    stop();
+  }
+
+  /// A pool shared by the whole program, which has one thread per hardware thread
+  static ThreadPool& shared()
+  {
+    static ThreadPool pool;
+    return pool;
+  }
+
+  /// Number of hardware threads, or 1 if it cannot be determined
+  static size_t defaultThreadCount() noexcept
+  {
+    size_t count = std::thread::hardware_concurrency();
+    return count > 0 ? count : 1;
+  }
+
+  /// Number of threads, which execute tasks, including the caller of run()
+  size_t threadCount() const noexcept
+  {
+    return m_workers.size() + 1;
+  }
+
+  ///
+  /// Calls task(i) for each i in [0, taskCount) and waits for all calls to complete
+  ///
+  /// The tasks are distributed dynamically, so the order in which they run is unspecified.
+  /// If a task throws, the tasks which have not started yet are skipped and
+  /// the first exception is rethrown after all running tasks complete.
+  ///
+  /// Calling run() from inside a task executes the nested tasks sequentially
+  /// on the calling thread.
+  ///
+  void run(size_t taskCount, const std::function<void(size_t)>& task)
+  {
+    if (taskCount == 0)
+      return;
+
+    if (m_workers.empty() || taskCount == 1 || insideTask()) {
+      for (size_t i = 0; i < taskCount; ++i)
+        task(i);
+      return;
+    }
+
+    std::lock_guard<std::mutex> runLock(m_runMutex);
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_task = &task;
+      m_taskCount = taskCount;
+      m_nextTask = 0;
+      m_busyWorkers = m_workers.size();
+      m_error = nullptr;
+      ++m_generation;
+    }
+    m_wakeUp.notify_all();
+
+    executeTasks();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_finished.wait(lock, [this] { return m_busyWorkers == 0; });
+    m_task = nullptr;
+
+    if (m_error)
+      std::rethrow_exception(m_error);
+  }
+
+private:
+  /// Set for threads, which are currently executing a task
+  static bool& insideTask() noexcept
+  {
+    static thread_local bool flag = false;
+    return flag;
+  }
+
+  void stop() noexcept
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stopping = true;
+    }
+    m_wakeUp.notify_all();
+
+    for (std::thread& worker : m_workers)
+      worker.join();
+
+    m_workers.clear();
+  }
+
+  /// Takes tasks from the current batch until there are no more left
+  void executeTasks() noexcept
+  {
+    insideTask() = true;
+
+    for (size_t i = m_nextTask++; i < m_taskCount; i = m_nextTask++) {
+      try {
+        (*m_task)(i);
+      }
+      catch (...) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if ( ! m_error)
+          m_error = std::current_exception();
+        m_nextTask = m_taskCount;
+      }
+    }
+
+    insideTask() = false;
+  }
+
+  void workerLoop() noexcept
+  {
+    size_t lastGeneration = 0;
+
+    for (;;) {
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_wakeUp.wait(lock, [&] { return m_stopping || m_generation != lastGeneration; });
+
+        if (m_stopping)
+          return;
+
+        lastGeneration = m_generation;
+      }
+
+      executeTasks();
+
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (--m_busyWorkers == 0)
+        m_finished.notify_one();
+    }
+  }
+};
@@ -0,0 +1,209 @@
+#include "catch2/catch_all.hpp"
+
+#include "ArrayKernels.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+/// All instruction sets supported by this machine
+template <typename T>
+std::vector<SimdLevel> supportedLevels()
+{
+  std::vector<SimdLevel> result;
+  for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2 }) {
+    if (ArrayKernels<T>::supports(level))
+      result.push_back(level);
+  }
+  return result;
+}
+
+/// Fills an array with pseudo-random values in [-1000, 1000]
+template <typename T>
+FixedSizeArray<T> randomArray(size_t size, unsigned seed = 42)
+{
+  std::mt19937 generator(seed);
+  FixedSizeArray<T> arr(size);
+
+  for (size_t i = 0; i < size; ++i) {
+    if constexpr (std::is_floating_point_v<T>)
+      arr[i] = std::uniform_real_distribution<T>(-1000, 1000)(generator);
+    else
+      arr[i] = static_cast<T>(std::uniform_int_distribution<int>(-1000, 1000)(generator));
+  }
+
+  return arr;
+}
+
+/// Checks whether two values have identical bit patterns
+template <typename T>
+bool sameBits(T a, T b)
+{
+  return std::memcmp(&a, &b, sizeof(T)) == 0;
+}
+
+TEST_CASE("ArrayKernels::supports() always supports the scalar implementation", "[ArrayKernels]")
+{
+  CHECK(ArrayKernels<int>::supports(SimdLevel::Scalar));
+  CHECK(ArrayKernels<int>::supports(ArrayKernels<int>::bestLevel()));
+}
+
+TEMPLATE_TEST_CASE("ArrayKernels produce the same results as plain loops", "[ArrayKernels]", int, unsigned, char, short, long long, float, double)
+{
+  // Sizes around the number of lanes and around the vector widths
+  const size_t size = GENERATE(1, 2, 7, 8, 9, 15, 16, 17, 31, 64, 1000, 1003);
+  FixedSizeArray<TestType> arr = randomArray<TestType>(size);
+  const TestType* data = arr.data();
+
+  TestType expectedMin = data[0];
+  TestType expectedMax = data[0];
+  size_t expectedCount = 0;
+  for (size_t i = 0; i < size; ++i) {
+    expectedMin = std::min(expectedMin, data[i]);
+    expectedMax = std::max(expectedMax, data[i]);
+    expectedCount += (data[i] == data[size / 2]);
+  }
+
+  for (SimdLevel level : supportedLevels<TestType>()) {
+    INFO("SimdLevel " << static_cast<int>(level) << ", size " << size);
+    CHECK(ArrayKernels<TestType>::min(data, size, level) == expectedMin);
+    CHECK(ArrayKernels<TestType>::max(data, size, level) == expectedMax);
+    CHECK(ArrayKernels<TestType>::count(data, size, data[size / 2], level) == expectedCount);
+    CHECK(ArrayKernels<TestType>::find(data, size, data[size - 1], level) <= size - 1);
+    CHECK(data[ArrayKernels<TestType>::find(data, size, data[size - 1], level)] == data[size - 1]);
+  }
+}
+
+TEMPLATE_TEST_CASE("ArrayKernels::sum() of integers matches a plain loop", "[ArrayKernels]", int, unsigned, long long)
+{
+  const size_t size = GENERATE(1, 7, 8, 9, 100, 1001);
+  FixedSizeArray<TestType> arr = randomArray<TestType>(size);
+
+  TestType expected = 0;
+  for (size_t i = 0; i < size; ++i)
+    expected += arr[i];
+
+  for (SimdLevel level : supportedLevels<TestType>())
+    CHECK(ArrayKernels<TestType>::sum(arr.data(), size, level) == expected);
+}
+
+TEST_CASE("ArrayKernels::sum() wraps around on integer overflow", "[ArrayKernels]")
+{
+  FixedSizeArray<int> arr(16);
+  for (size_t i = 0; i < arr.size(); ++i)
+    arr[i] = std::numeric_limits<int>::max();
+
+  for (SimdLevel level : supportedLevels<int>())
+    CHECK(ArrayKernels<int>::sum(arr.data(), arr.size(), level) == -16);
+}
+
+TEMPLATE_TEST_CASE("ArrayKernels produce bit-identical floating point results with all instruction sets", "[ArrayKernels]", float, double)
+{
+  const size_t size = GENERATE(5, 8, 13, 100, 12345);
+  FixedSizeArray<TestType> arr = randomArray<TestType>(size, 7);
+
+  const TestType scalarSum = ArrayKernels<TestType>::sum(arr.data(), size, SimdLevel::Scalar);
+
+  for (SimdLevel level : supportedLevels<TestType>())
+    CHECK(sameBits(ArrayKernels<TestType>::sum(arr.data(), size, level), scalarSum));
+}
+
+TEST_CASE("ArrayKernels::min() and max() handle NaN in the same way with all instruction sets", "[ArrayKernels]")
+{
+  FixedSizeArray<double> arr = randomArray<double>(37);
+  arr[3] = std::numeric_limits<double>::quiet_NaN();
+  arr[20] = std::numeric_limits<double>::quiet_NaN();
+  arr[36] = -0.0;
+
+  const double scalarMin = ArrayKernels<double>::min(arr.data(), arr.size(), SimdLevel::Scalar);
+  const double scalarMax = ArrayKernels<double>::max(arr.data(), arr.size(), SimdLevel::Scalar);
+
+  for (SimdLevel level : supportedLevels<double>()) {
+    CHECK(sameBits(ArrayKernels<double>::min(arr.data(), arr.size(), level), scalarMin));
+    CHECK(sameBits(ArrayKernels<double>::max(arr.data(), arr.size(), level), scalarMax));
+  }
+}
+
+TEST_CASE("ArrayKernels::count() does not overflow the lane counters for narrow types", "[ArrayKernels]")
+{
+  FixedSizeArray<char> arr(10'000);
+  for (size_t i = 0; i < arr.size(); ++i)
+    arr[i] = 'x';
+
+  for (SimdLevel level : supportedLevels<char>())
+    CHECK(ArrayKernels<char>::count(arr.data(), arr.size(), 'x', level) == arr.size());
+}
+
+TEST_CASE("ArrayKernels::find() returns the size of the array when the value is missing", "[ArrayKernels]")
+{
+  FixedSizeArray<int> arr = randomArray<int>(100);
+  const int missing = 5000;
+
+  for (SimdLevel level : supportedLevels<int>())
+    CHECK(ArrayKernels<int>::find(arr.data(), arr.size(), missing, level) == arr.size());
+}
+
+TEST_CASE("ArrayKernels::find() returns the first of several matches", "[ArrayKernels]")
+{
+  FixedSizeArray<float> arr(64);
+  for (size_t i = 0; i < arr.size(); ++i)
+    arr[i] = 0;
+  arr[21] = 1;
+  arr[22] = 1;
+  arr[50] = 1;
+
+  for (SimdLevel level : supportedLevels<float>())
+    CHECK(ArrayKernels<float>::find(arr.data(), arr.size(), 1.0f, level) == 21);
+}
+
+TEST_CASE("Array algorithms can be called on FixedSizeArray and DynamicArray objects", "[ArrayKernels]")
+{
+  DynamicArray<int> dynamic;
+  for (int i = 1; i <= 10; ++i)
+    dynamic.push_back(i);
+
+  FixedSizeArray<int> fixed(10);
+  for (size_t i = 0; i < fixed.size(); ++i)
+    fixed[i] = dynamic[i];
+
+  CHECK(sum(dynamic) == 55);
+  CHECK(sum(fixed) == 55);
+  CHECK(minValue(dynamic) == 1);
+  CHECK(minValue(fixed) == 1);
+  CHECK(maxValue(dynamic) == 10);
+  CHECK(maxValue(fixed) == 10);
+  CHECK(count(dynamic, 3) == 1);
+  CHECK(count(fixed, 11) == 0);
+  CHECK(find(dynamic, 4) == 3);
+  CHECK(find(fixed, 11) == fixed.size());
+}
+
+TEST_CASE("minValue() and maxValue() throw for empty arrays", "[ArrayKernels]")
+{
+  DynamicArray<int> dynamic;
+  FixedSizeArray<int> fixed;
+
+  CHECK_THROWS_AS(minValue(dynamic), DynamicArray<int>::EmptyArrayException);
+  CHECK_THROWS_AS(maxValue(dynamic), DynamicArray<int>::EmptyArrayException);
+  CHECK_THROWS_AS(minValue(fixed), std::logic_error);
+  CHECK_THROWS_AS(maxValue(fixed), std::logic_error);
+  CHECK(sum(dynamic) == 0);
+}
+
+TEMPLATE_TEST_CASE("ArrayKernels throughput for each instruction set", "[.][benchmark]", int, float, double)
+{
+  FixedSizeArray<TestType> arr = randomArray<TestType>(1'000'000);
+  const TestType missing = static_cast<TestType>(5000);
+
+  for (SimdLevel level : supportedLevels<TestType>()) {
+    const std::string suffix = " (SimdLevel " + std::to_string(static_cast<int>(level)) + ")";
+
+    BENCHMARK("sum" + suffix) { return ArrayKernels<TestType>::sum(arr.data(), arr.size(), level); };
+    BENCHMARK("min" + suffix) { return ArrayKernels<TestType>::min(arr.data(), arr.size(), level); };
+    BENCHMARK("count" + suffix) { return ArrayKernels<TestType>::count(arr.data(), arr.size(), arr[0], level); };
+    BENCHMARK("find" + suffix) { return ArrayKernels<TestType>::find(arr.data(), arr.size(), missing, level); };
+  }
+}
@@ -3,6 +3,11 @@
 #include "DynamicArray.h"
 
 #include <cassert>
+#include <chrono>
+
+#if defined(__linux__)
+#include <sys/resource.h>
+#endif
 
 template <typename T>
 void checkEmpty(DynamicArray<T>& arr)
@@ -403,4 +408,58 @@ TEST_CASE_METHOD(ConsecutiveNumbersFixture, "DynamicArray::swap() correctly swap
     CHECK(arr.capacity() == capacityAnother);
     CHECK(another.capacity() == initialCapacity);
   }
-}
\ No newline at end of file
+}
+
+TEST_CASE("DynamicArray::reserve() preserves the contents when growing past the mapped storage threshold", "[DynamicArray]")
+{
+  const size_t threshold = FixedSizeArray<char>::MappedStorageThreshold;
+  DynamicArray<char> arr;
+
+  for (char c = 'a'; c <= 'z'; ++c)
+    arr.push_back(c);
+
+  SECTION("Growing from a heap buffer to a mapped one") {
+    arr.reserve(threshold);
+  }
+  SECTION("Growing a mapped buffer") {
+    arr.reserve(threshold);
+    arr.reserve(threshold + 1);
+    REQUIRE(arr.capacity() == threshold * 2);
+  }
+
+  REQUIRE(arr.size() == 26);
+  for (size_t i = 0; i < arr.size(); ++i)
+    CHECK(arr[i] == static_cast<char>('a' + i));
+}
+
+//
+// Appends elements one by one until the array occupies a given number of gigabytes
+// and reports the throughput and the peak resident set size of the process.
+// The sizes are processed in ascending order, so the peak reported after each one
+// is the peak for that size.
+//
+// This test is hidden. Run it explicitly with: unit-tests "[benchmark]"
+//
+TEST_CASE("DynamicArray::push_back() throughput and peak memory for huge arrays", "[.][benchmark]")
+{
+  const size_t gigabytes = GENERATE(1, 2, 4, 8, 16);
+  const size_t count = gigabytes * 1024 * 1024 * 1024 / sizeof(size_t);
+
+  auto start = std::chrono::steady_clock::now();
+  {
+    DynamicArray<size_t> arr;
+    for (size_t i = 0; i < count; ++i)
+      arr.push_back(i);
+    REQUIRE(arr.size() == count);
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  long peakRssMb = 0;
+#if defined(__linux__)
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  peakRssMb = usage.ru_maxrss / 1024;
+#endif
+
+  WARN(gigabytes << " GB: " << (count / elapsed.count() / 1e6) << " M appends/s, peak RSS " << peakRssMb << " MB");
+}
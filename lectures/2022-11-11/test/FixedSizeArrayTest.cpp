@@ -559,3 +559,61 @@ SCENARIO("FixedSizeArray::operator=(FixedSizeArray&&) correctly moves to a non-e
 }
 
 
+
+
+SCENARIO("FixedSizeArray::growInPlace() does nothing for arrays below the mapped storage threshold", "[FixedSizeArray]")
+{
+  GIVEN("A small non-empty array")
+  {
+    ArrayOfNumbersFixture fx;
+    const size_t* buffer = fx.arr.data();
+
+    WHEN("We try to grow it in place") {
+      bool grown = fx.arr.growInPlace(fx.initialSize * 2);
+
+      THEN("The operation is rejected and the array remains unchanged") {
+        CHECK_FALSE(grown);
+        CHECK(fx.arr.data() == buffer);
+        CHECK(fx.arrayIsSameAsWhenFirstCreated());
+      }
+    }
+  }
+}
+
+SCENARIO("FixedSizeArray::growInPlace() preserves the contents of huge arrays", "[FixedSizeArray]")
+{
+  GIVEN("An array at the mapped storage threshold with some of its elements set")
+  {
+    const size_t size = FixedSizeArray<char>::MappedStorageThreshold;
+    FixedSizeArray<char> arr(size);
+    arr[0] = 'a';
+    arr[size / 2] = 'b';
+    arr[size - 1] = 'c';
+
+    WHEN("We grow it in place") {
+      bool grown = arr.growInPlace(size * 2);
+
+      THEN("Either the operation is not supported, or the size changes and the elements remain the same") {
+        if (grown) {
+          CHECK(arr.size() == size * 2);
+          CHECK(arr[0] == 'a');
+          CHECK(arr[size / 2] == 'b');
+          CHECK(arr[size - 1] == 'c');
+          CHECK(arr[size] == 0);
+          CHECK(arr[size * 2 - 1] == 0);
+        }
+        else {
+          CHECK_FALSE(FixedSizeArray<char>::usesMappedStorage(size));
+          CHECK(arr.size() == size);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("FixedSizeArray::usesMappedStorage() is false for small arrays and non-trivial types", "[FixedSizeArray]")
+{
+  CHECK_FALSE(FixedSizeArray<int>::usesMappedStorage(0));
+  CHECK_FALSE(FixedSizeArray<int>::usesMappedStorage(10));
+  CHECK_FALSE(FixedSizeArray<FixedSizeArray<int>>::usesMappedStorage(FixedSizeArray<int>::MappedStorageThreshold));
+}
@@ -0,0 +1,249 @@
+#include "catch2/catch_all.hpp"
+
+#include "GapBuffer.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+TEST_CASE("GapBuffer::GapBuffer() constructs an empty buffer", "[GapBuffer]")
+{
+  GapBuffer<> buffer;
+  CHECK(buffer.empty());
+  CHECK(buffer.size() == 0);
+  CHECK(buffer.cursor() == 0);
+  CHECK(buffer.toString().empty());
+}
+
+TEST_CASE("GapBuffer::GapBuffer(text) places the cursor at the end", "[GapBuffer]")
+{
+  GapBuffer<> buffer("hello");
+  CHECK(buffer.size() == 5);
+  CHECK(buffer.cursor() == 5);
+  CHECK(buffer.toString() == "hello");
+}
+
+SCENARIO("Editing a GapBuffer around the cursor", "[GapBuffer]")
+{
+  GIVEN("A buffer with some text")
+  {
+    GapBuffer<> buffer("hello world");
+
+    WHEN("the cursor is moved and text is inserted")
+    {
+      buffer.moveCursor(5);
+      buffer.insert(',');
+      buffer.insert(" dear");
+
+      THEN("the text is inserted at the cursor, which ends up after it")
+      {
+        CHECK(buffer.toString() == "hello, dear world");
+        CHECK(buffer.cursor() == 11);
+        CHECK(buffer.before() == "hello, dear");
+        CHECK(buffer.after() == " world");
+      }
+    }
+
+    WHEN("characters are erased on both sides of the cursor")
+    {
+      buffer.moveCursor(6);
+      buffer.eraseBefore();
+      buffer.eraseAfter(2);
+
+      THEN("the characters around the cursor are removed")
+      {
+        CHECK(buffer.toString() == "hellorld");
+        CHECK(buffer.cursor() == 5);
+      }
+    }
+
+    WHEN("the cursor is moved back and forth")
+    {
+      buffer.moveCursor(0);
+      buffer.moveCursor(11);
+      buffer.moveCursor(3);
+
+      THEN("the text does not change")
+      {
+        CHECK(buffer.toString() == "hello world");
+        CHECK(buffer.cursor() == 3);
+      }
+    }
+  }
+}
+
+TEST_CASE("GapBuffer provides access to characters by their position in the text", "[GapBuffer]")
+{
+  GapBuffer<> buffer("abcdef");
+  buffer.moveCursor(2);
+
+  CHECK(buffer[1] == 'b');
+  CHECK(buffer[2] == 'c');
+  CHECK(buffer.at(5) == 'f');
+
+  buffer.at(3) = 'X';
+  CHECK(buffer.toString() == "abcXef");
+  CHECK_THROWS_AS(buffer.at(6), std::out_of_range);
+}
+
+TEST_CASE("GapBuffer throws when moving the cursor or erasing out of bounds", "[GapBuffer]")
+{
+  GapBuffer<> buffer("abc");
+  buffer.moveCursor(1);
+
+  CHECK_THROWS_AS(buffer.moveCursor(4), std::out_of_range);
+  CHECK_THROWS_AS(buffer.eraseBefore(2), std::out_of_range);
+  CHECK_THROWS_AS(buffer.eraseAfter(3), std::out_of_range);
+  CHECK(buffer.toString() == "abc");
+  CHECK(buffer.cursor() == 1);
+}
+
+TEST_CASE("GapBuffer::view() returns the whole text as a contiguous view", "[GapBuffer]")
+{
+  GapBuffer<> buffer("hello world");
+  buffer.moveCursor(4);
+
+  CHECK(buffer.view() == "hello world");
+  CHECK(buffer.cursor() == buffer.size());
+}
+
+TEST_CASE("GapBuffer grows when the gap is exhausted", "[GapBuffer]")
+{
+  GapBuffer<> buffer("tail");
+  buffer.moveCursor(0);
+
+  std::string expected;
+  for (int i = 0; i < 1000; ++i) {
+    buffer.insert(static_cast<char>('a' + i % 26));
+    expected += static_cast<char>('a' + i % 26);
+  }
+
+  CHECK(buffer.capacity() >= buffer.size());
+  CHECK(buffer.toString() == expected + "tail");
+  CHECK(buffer.after() == "tail");
+}
+
+TEST_CASE("GapBuffer moves the cursor when the gap is exactly filled", "[GapBuffer]")
+{
+  GapBuffer<> buffer("ab");
+  std::string expected = "ab";
+
+  while (buffer.capacity() > buffer.size()) {
+    buffer.insert('x');
+    expected += 'x';
+  }
+
+  buffer.moveCursor(1);
+  CHECK(buffer.cursor() == 1);
+  CHECK(buffer.toString() == expected);
+
+  buffer.moveCursor(buffer.size());
+  CHECK(buffer.toString() == expected);
+
+  buffer.moveCursor(0);
+  buffer.insert('c');
+  CHECK(buffer.toString() == "c" + expected);
+  CHECK(buffer.after() == expected);
+}
+
+TEST_CASE("GapBuffer supports wide characters", "[GapBuffer]")
+{
+  GapBuffer<wchar_t> buffer(L"wide");
+  buffer.moveCursor(0);
+  buffer.insert(L"very ");
+  CHECK(buffer.toString() == L"very wide");
+}
+
+/// One step of a simulated editing session
+struct Edit {
+  size_t position;
+  bool insertion;
+  char character;
+};
+
+/// Generates an edit trace, in which the cursor mostly stays close to its previous position
+std::vector<Edit> makeEditTrace(size_t initialSize, size_t length, unsigned seed = 42)
+{
+  std::mt19937 generator(seed);
+  std::uniform_int_distribution<int> jump(-16, 16);
+  std::uniform_int_distribution<int> action(0, 9);
+
+  std::vector<Edit> trace;
+  size_t size = initialSize;
+  size_t position = initialSize / 2;
+
+  for (size_t i = 0; i < length; ++i) {
+    const long moved = static_cast<long>(position) + jump(generator);
+    position = static_cast<size_t>(std::clamp<long>(moved, 0, static_cast<long>(size)));
+
+    const bool insertion = action(generator) < 7 || position == 0;
+    trace.push_back({ position, insertion, static_cast<char>('a' + i % 26) });
+
+    if (insertion) {
+      ++size;
+      ++position;
+    }
+    else {
+      --size;
+      --position;
+    }
+  }
+
+  return trace;
+}
+
+TEST_CASE("GapBuffer produces the same text as std::string for an edit trace", "[GapBuffer]")
+{
+  std::string reference(500, '.');
+  GapBuffer<> buffer(reference);
+
+  for (const Edit& edit : makeEditTrace(reference.size(), 5000)) {
+    buffer.moveCursor(edit.position);
+    if (edit.insertion) {
+      buffer.insert(edit.character);
+      reference.insert(edit.position, 1, edit.character);
+    }
+    else {
+      buffer.eraseBefore();
+      reference.erase(edit.position - 1, 1);
+    }
+  }
+
+  CHECK(buffer.toString() == reference);
+}
+
+//
+// This test is hidden. Run it explicitly with: unit-tests "[benchmark]"
+//
+TEST_CASE("GapBuffer and std::string performance for an edit trace", "[.][benchmark]")
+{
+  const size_t documentSize = GENERATE(10'000, 1'000'000);
+  const std::string document(documentSize, '.');
+  const std::vector<Edit> trace = makeEditTrace(documentSize, 100'000);
+
+  BENCHMARK("GapBuffer, " + std::to_string(documentSize) + " characters")
+  {
+    GapBuffer<> buffer(document);
+    for (const Edit& edit : trace) {
+      buffer.moveCursor(edit.position);
+      if (edit.insertion)
+        buffer.insert(edit.character);
+      else
+        buffer.eraseBefore();
+    }
+    return buffer.size();
+  };
+
+  BENCHMARK("std::string, " + std::to_string(documentSize) + " characters")
+  {
+    std::string text = document;
+    for (const Edit& edit : trace) {
+      if (edit.insertion)
+        text.insert(edit.position, 1, edit.character);
+      else
+        text.erase(edit.position - 1, 1);
+    }
+    return text.size();
+  };
+}
@@ -0,0 +1,158 @@
+#include "catch2/catch_all.hpp"
+
+#include "JaggedArray.h"
+
+#include <random>
+#include <vector>
+
+TEST_CASE("JaggedArray::JaggedArray() constructs an array without rows", "[JaggedArray]")
+{
+  JaggedArray<int> arr;
+  CHECK(arr.empty());
+  CHECK(arr.rowCount() == 0);
+  CHECK(arr.size() == 0);
+  CHECK_THROWS_AS(arr.at(0), std::out_of_range);
+}
+
+TEST_CASE("JaggedArray::JaggedArray(values, offsets) validates the offsets", "[JaggedArray]")
+{
+  FixedSizeArray<int> values(3);
+  FixedSizeArray<size_t> descending(3);
+  descending[0] = 0;
+  descending[1] = 2;
+  descending[2] = 1;
+  CHECK_THROWS_AS(JaggedArray<int>(FixedSizeArray<int>(values), std::move(descending)), std::invalid_argument);
+
+  FixedSizeArray<size_t> tooShort(2);
+  tooShort[0] = 0;
+  tooShort[1] = 2;
+  CHECK_THROWS_AS(JaggedArray<int>(FixedSizeArray<int>(values), std::move(tooShort)), std::invalid_argument);
+
+  CHECK_THROWS_AS(JaggedArray<int>(FixedSizeArray<int>(values), FixedSizeArray<size_t>()), std::invalid_argument);
+}
+
+SCENARIO("Building a JaggedArray", "[JaggedArray]")
+{
+  GIVEN("A builder with rows of different lengths, including empty ones")
+  {
+    JaggedArrayBuilder<int> builder;
+
+    builder.appendRow();
+    builder.push_back(1);
+    builder.push_back(2);
+    builder.appendRow();
+    const std::vector<int> third = { 3, 4, 5 };
+    builder.appendRow(third.begin(), third.end());
+    builder.appendRow();
+
+    REQUIRE(builder.rowCount() == 4);
+
+    WHEN("the array is finalized")
+    {
+      JaggedArray<int> arr = builder.finalize();
+
+      THEN("the rows have the appended elements")
+      {
+        REQUIRE(arr.rowCount() == 4);
+        CHECK(arr.size() == 5);
+        CHECK(arr.rowSize(0) == 2);
+        CHECK(arr[1].empty());
+        CHECK(arr[3].empty());
+        CHECK(std::vector<int>(arr[2].begin(), arr[2].end()) == third);
+        CHECK(arr.at(0)[1] == 2);
+      }
+
+      THEN("the rows are stored back to back")
+      {
+        CHECK(arr[2].data() == arr[0].data() + 2);
+        CHECK(arr.values().size() == 5);
+        CHECK(arr.values()[4] == 5);
+      }
+
+      THEN("the elements can be modified through the rows")
+      {
+        arr[2][0] = 30;
+        CHECK(arr.values()[2] == 30);
+      }
+
+      THEN("the builder is empty and can be reused")
+      {
+        CHECK(builder.rowCount() == 0);
+        builder.appendRow();
+        builder.push_back(7);
+        CHECK(builder.finalize()[0][0] == 7);
+      }
+    }
+  }
+}
+
+TEST_CASE("JaggedArrayBuilder::push_back() throws before the first row is started", "[JaggedArray]")
+{
+  JaggedArrayBuilder<int> builder;
+  CHECK_THROWS_AS(builder.push_back(1), std::logic_error);
+}
+
+TEST_CASE("JaggedArrayBuilder::finalize() without rows creates an empty array", "[JaggedArray]")
+{
+  JaggedArrayBuilder<int> builder;
+  JaggedArray<int> arr = builder.finalize();
+  CHECK(arr.empty());
+}
+
+/// Lengths of the rows of a typical adjacency list: mostly short, some long
+std::vector<size_t> randomRowLengths(size_t rows, unsigned seed = 42)
+{
+  std::mt19937 generator(seed);
+  std::geometric_distribution<size_t> length(0.1);
+
+  std::vector<size_t> result(rows);
+  for (size_t& value : result)
+    value = length(generator);
+
+  return result;
+}
+
+//
+// This test is hidden. Run it explicitly with: unit-tests "[benchmark]"
+//
+TEST_CASE("JaggedArray and nested DynamicArray full scan performance", "[.][benchmark]")
+{
+  const size_t rows = 1'000'000;
+  const std::vector<size_t> lengths = randomRowLengths(rows);
+
+  DynamicArray<DynamicArray<int>> nested;
+  JaggedArrayBuilder<int> builder;
+
+  for (size_t i = 0; i < rows; ++i) {
+    DynamicArray<int> row;
+    builder.appendRow();
+    for (size_t j = 0; j < lengths[i]; ++j) {
+      row.push_back(static_cast<int>(i + j));
+      builder.push_back(static_cast<int>(i + j));
+    }
+    nested.push_back(row);
+  }
+
+  JaggedArray<int> jagged = builder.finalize();
+
+  BENCHMARK("DynamicArray<DynamicArray<int>>")
+  {
+    long long total = 0;
+    for (size_t i = 0; i < nested.size(); ++i) {
+      const DynamicArray<int>& row = nested[i];
+      for (size_t j = 0; j < row.size(); ++j)
+        total += row[j];
+    }
+    return total;
+  };
+
+  BENCHMARK("JaggedArray<int>")
+  {
+    long long total = 0;
+    for (size_t i = 0; i < jagged.rowCount(); ++i) {
+      for (int value : jagged[i])
+        total += value;
+    }
+    return total;
+  };
+}
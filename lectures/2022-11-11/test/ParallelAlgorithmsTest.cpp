@@ -0,0 +1,130 @@
+#include "catch2/catch_all.hpp"
+
+#include "DynamicArray.h"
+#include "ParallelAlgorithms.h"
+
+#include <functional>
+
+/// Creates an array with the numbers 1, 2, ..., size
+DynamicArray<long long> consecutiveNumbers(size_t size)
+{
+  DynamicArray<long long> arr(size);
+  for (size_t i = 0; i < size; ++i)
+    arr[i] = i + 1;
+  return arr;
+}
+
+TEST_CASE("ParallelChunks covers the whole array with non-overlapping chunks", "[ParallelAlgorithms]")
+{
+  const size_t size = GENERATE(0, 1, 100, 4095, 100'000, 1'000'003);
+  FixedSizeArray<char> arr(size + 1);
+
+  // Check both aligned and misaligned buffers
+  const char* data = arr.data() + GENERATE(0, 1);
+
+  ParallelChunks<char> chunks(data, size, 4);
+  REQUIRE(chunks.count() >= 1);
+  CHECK(chunks.begin(0) == 0);
+  CHECK(chunks.end(chunks.count() - 1) == size);
+
+  for (size_t chunk = 1; chunk < chunks.count(); ++chunk) {
+    CHECK(chunks.begin(chunk) == chunks.end(chunk - 1));
+    CHECK(chunks.begin(chunk) < chunks.end(chunk));
+    CHECK(reinterpret_cast<std::uintptr_t>(data + chunks.begin(chunk)) % ParallelChunks<char>::CacheLineBytes == 0);
+  }
+}
+
+TEST_CASE("Parallel algorithms produce the same results as sequential loops", "[ParallelAlgorithms]")
+{
+  const size_t threads = GENERATE(1, 2, 4);
+  const size_t size = GENERATE(0, 1, 1000, 100'000);
+  ThreadPool pool(threads);
+
+  DynamicArray<long long> arr = consecutiveNumbers(size);
+
+  SECTION("parallelFor() visits each element once") {
+    parallelFor(arr, [](long long& x) { x *= 2; }, pool);
+
+    for (size_t i = 0; i < size; ++i)
+      REQUIRE(arr[i] == 2 * (long long)(i + 1));
+  }
+  SECTION("parallelTransform() stores the results in the output array") {
+    DynamicArray<long long> out(size);
+    parallelTransform(arr, out, [](long long x) { return x * x; }, pool);
+
+    for (size_t i = 0; i < size; ++i)
+      REQUIRE(out[i] == arr[i] * arr[i]);
+  }
+  SECTION("parallelReduce() combines all elements") {
+    const long long n = size;
+    CHECK(parallelReduce(arr, 10LL, std::plus<long long>(), pool) == 10 + n * (n + 1) / 2);
+  }
+  SECTION("parallelInclusiveScan() computes prefix sums") {
+    DynamicArray<long long> out(size);
+    parallelInclusiveScan(arr, out, std::plus<long long>(), pool);
+
+    for (size_t i = 0; i < size; ++i)
+      REQUIRE(out[i] == (long long)((i + 1) * (i + 2) / 2));
+  }
+  SECTION("parallelExclusiveScan() computes prefix sums") {
+    DynamicArray<long long> out(size);
+    parallelExclusiveScan(arr, out, 5LL, std::plus<long long>(), pool);
+
+    for (size_t i = 0; i < size; ++i)
+      REQUIRE(out[i] == 5 + (long long)(i * (i + 1) / 2));
+  }
+  SECTION("Scans can be computed in place") {
+    DynamicArray<long long> copy = arr;
+    parallelInclusiveScan(arr, arr, std::plus<long long>(), pool);
+    parallelExclusiveScan(copy, copy, 0LL, std::plus<long long>(), pool);
+
+    for (size_t i = 0; i < size; ++i) {
+      REQUIRE(arr[i] == (long long)((i + 1) * (i + 2) / 2));
+      REQUIRE(copy[i] == (long long)(i * (i + 1) / 2));
+    }
+  }
+}
+
+TEST_CASE("Parallel algorithms throw when the output array is too small", "[ParallelAlgorithms]")
+{
+  DynamicArray<long long> arr = consecutiveNumbers(10);
+  DynamicArray<long long> out(5);
+  auto identity = [](long long x) { return x; };
+
+  CHECK_THROWS_AS(parallelTransform(arr, out, identity), std::invalid_argument);
+  CHECK_THROWS_AS(parallelInclusiveScan(arr, out, std::plus<long long>()), std::invalid_argument);
+  CHECK_THROWS_AS(parallelExclusiveScan(arr, out, 0LL, std::plus<long long>()), std::invalid_argument);
+}
+
+TEST_CASE("Parallel algorithms work with FixedSizeArray", "[ParallelAlgorithms]")
+{
+  FixedSizeArray<int> arr(1000);
+  parallelFor(arr, [](int& x) { x = 1; });
+  CHECK(parallelReduce(arr, 0, std::plus<int>()) == 1000);
+}
+
+TEST_CASE("Parallel algorithms scale with the number of threads", "[.][benchmark]")
+{
+  const size_t size = 50'000'000;
+  DynamicArray<double> arr(size);
+  DynamicArray<double> out(size);
+  for (size_t i = 0; i < size; ++i)
+    arr[i] = i % 1000;
+
+  for (size_t threads = 1; threads <= ThreadPool::defaultThreadCount(); threads *= 2) {
+    ThreadPool pool(threads);
+    const std::string suffix = " (" + std::to_string(threads) + " threads)";
+
+    BENCHMARK("parallelTransform" + suffix) {
+      parallelTransform(arr, out, [](double x) { return x * 0.5 + 1; }, pool);
+      return out[0];
+    };
+    BENCHMARK("parallelReduce" + suffix) {
+      return parallelReduce(arr, 0.0, std::plus<double>(), pool);
+    };
+    BENCHMARK("parallelInclusiveScan" + suffix) {
+      parallelInclusiveScan(arr, out, std::plus<double>(), pool);
+      return out[size - 1];
+    };
+  }
+}
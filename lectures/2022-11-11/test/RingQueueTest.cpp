@@ -0,0 +1,298 @@
+#include "catch2/catch_all.hpp"
+
+#include "RingQueue.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using QueueTypes = std::tuple<SpscQueue<int>, MpmcQueue<int>>;
+
+TEMPLATE_LIST_TEST_CASE("Queue capacity is rounded up to a power of two", "[RingQueue]", QueueTypes)
+{
+  CHECK(TestType(1).capacity() == 1);
+  CHECK(TestType(5).capacity() == 8);
+  CHECK(TestType(8).capacity() == 8);
+  CHECK_THROWS_AS(TestType(0), std::invalid_argument);
+}
+
+TEMPLATE_LIST_TEST_CASE("Queues return elements in FIFO order", "[RingQueue]", QueueTypes)
+{
+  TestType queue(4);
+  int value = 0;
+
+  // Go around the ring several times
+  for (int lap = 0; lap < 5; ++lap) {
+    for (int i = 0; i < 3; ++i)
+      REQUIRE(queue.tryPush(lap * 10 + i));
+
+    for (int i = 0; i < 3; ++i) {
+      REQUIRE(queue.tryPop(value));
+      REQUIRE(value == lap * 10 + i);
+    }
+  }
+}
+
+TEMPLATE_LIST_TEST_CASE("Queue::tryPop() fails when the queue is empty", "[RingQueue]", QueueTypes)
+{
+  TestType queue(4);
+  int value = 42;
+
+  CHECK_FALSE(queue.tryPop(value));
+  CHECK(value == 42);
+
+  queue.tryPush(1);
+  queue.tryPop(value);
+  CHECK_FALSE(queue.tryPop(value));
+}
+
+TEMPLATE_LIST_TEST_CASE("Queue::tryPush() fails when the queue is full", "[RingQueue]", QueueTypes)
+{
+  TestType queue(4);
+
+  for (int i = 0; i < 4; ++i)
+    REQUIRE(queue.tryPush(i));
+
+  CHECK_FALSE(queue.tryPush(4));
+
+  int value;
+  REQUIRE(queue.tryPop(value));
+  CHECK(value == 0);
+  CHECK(queue.tryPush(4));
+}
+
+/// Value, whose copy can be made to throw
+struct ThrowingCopy {
+  static inline bool throwOnCopy = false;
+  int value = 0;
+
+  ThrowingCopy() = default;
+  explicit ThrowingCopy(int value) : value(value) {}
+  ThrowingCopy(ThrowingCopy&&) noexcept = default;
+  ThrowingCopy& operator=(ThrowingCopy&&) noexcept = default;
+
+  ThrowingCopy(const ThrowingCopy& other) : value(other.value)
+  {
+    if (throwOnCopy)
+      throw std::runtime_error("copy failed");
+  }
+
+  ThrowingCopy& operator=(const ThrowingCopy& other)
+  {
+    if (throwOnCopy)
+      throw std::runtime_error("copy failed");
+
+    value = other.value;
+    return *this;
+  }
+};
+
+TEST_CASE("MpmcQueue stays usable when copying a pushed value throws", "[RingQueue]")
+{
+  MpmcQueue<ThrowingCopy> queue(2);
+  const ThrowingCopy first(1), second(2);
+  ThrowingCopy result;
+
+  REQUIRE(queue.tryPush(first));
+
+  ThrowingCopy::throwOnCopy = true;
+  CHECK_THROWS_AS(queue.tryPush(second), std::runtime_error);
+  ThrowingCopy::throwOnCopy = false;
+
+  // The failed push has not claimed a slot
+  REQUIRE(queue.tryPush(second));
+  CHECK_FALSE(queue.tryPush(ThrowingCopy(3)));
+
+  REQUIRE(queue.tryPop(result));
+  CHECK(result.value == 1);
+  REQUIRE(queue.tryPop(result));
+  CHECK(result.value == 2);
+  CHECK_FALSE(queue.tryPop(result));
+
+  REQUIRE(queue.tryPush(ThrowingCopy(4)));
+  REQUIRE(queue.tryPop(result));
+  CHECK(result.value == 4);
+}
+
+TEST_CASE("SpscQueue transfers all elements in order between two threads", "[RingQueue]")
+{
+  const int count = 200'000;
+  SpscQueue<int> queue(64);
+
+  std::thread producer([&] {
+    for (int i = 0; i < count; ++i) {
+      while ( ! queue.tryPush(i))
+        std::this_thread::yield();
+    }
+  });
+
+  bool inOrder = true;
+  for (int expected = 0; expected < count; ++expected) {
+    int value;
+    while ( ! queue.tryPop(value))
+      std::this_thread::yield();
+    inOrder = inOrder && (value == expected);
+  }
+
+  producer.join();
+  CHECK(inOrder);
+}
+
+TEST_CASE("MpmcQueue transfers each element exactly once between many threads", "[RingQueue]")
+{
+  const int producers = 4;
+  const int consumers = 4;
+  const int countPerProducer = 50'000;
+  MpmcQueue<int> queue(128);
+
+  std::vector<std::atomic<int>> received(producers * countPerProducer);
+  std::atomic<int> remaining{producers * countPerProducer};
+  std::vector<std::thread> threads;
+
+  for (int p = 0; p < producers; ++p) {
+    threads.emplace_back([&, p] {
+      for (int i = 0; i < countPerProducer; ++i) {
+        while ( ! queue.tryPush(p * countPerProducer + i))
+          std::this_thread::yield();
+      }
+    });
+  }
+
+  for (int c = 0; c < consumers; ++c) {
+    threads.emplace_back([&] {
+      int value;
+      while (remaining > 0) {
+        if (queue.tryPop(value)) {
+          ++received[value];
+          --remaining;
+        }
+        else {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  for (std::thread& t : threads)
+    t.join();
+
+  bool eachReceivedOnce = true;
+  for (auto& r : received)
+    eachReceivedOnce = eachReceivedOnce && (r == 1);
+
+  CHECK(eachReceivedOnce);
+}
+
+/// The mutex-protected queue, against which the lock-free ones are compared
+template <typename T>
+class MutexQueue {
+  std::mutex m_mutex;
+  std::queue<T> m_queue;
+  size_t m_capacity;
+
+public:
+  explicit MutexQueue(size_t capacity) : m_capacity(capacity) {}
+
+  bool tryPush(const T& value)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_queue.size() == m_capacity)
+      return false;
+    m_queue.push(value);
+    return true;
+  }
+
+  bool tryPop(T& result)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_queue.empty())
+      return false;
+    result = m_queue.front();
+    m_queue.pop();
+    return true;
+  }
+};
+
+/// Measures how many items per second `pairs` producer/consumer pairs pass through a queue
+template <typename Queue>
+double measureThroughput(size_t pairs, size_t itemsPerProducer)
+{
+  Queue queue(1024);
+  std::atomic<size_t> remaining{pairs * itemsPerProducer};
+  std::vector<std::thread> threads;
+
+  auto start = std::chrono::steady_clock::now();
+
+  for (size_t p = 0; p < pairs; ++p) {
+    threads.emplace_back([&] {
+      for (size_t i = 0; i < itemsPerProducer; ++i) {
+        while ( ! queue.tryPush(i))
+          std::this_thread::yield();
+      }
+    });
+    threads.emplace_back([&] {
+      size_t value;
+      while (remaining.load(std::memory_order_relaxed) > 0) {
+        if (queue.tryPop(value))
+          remaining.fetch_sub(1, std::memory_order_relaxed);
+        else
+          std::this_thread::yield();
+      }
+    });
+  }
+
+  for (std::thread& t : threads)
+    t.join();
+
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  return pairs * itemsPerProducer / elapsed.count();
+}
+
+/// Measures the average one-way latency in nanoseconds by bouncing a value between two threads
+template <typename Queue>
+double measureLatency(size_t roundTrips)
+{
+  Queue ping(64), pong(64);
+
+  std::thread echo([&] {
+    size_t value;
+    for (size_t i = 0; i < roundTrips; ++i) {
+      while ( ! ping.tryPop(value)) {}
+      while ( ! pong.tryPush(value)) {}
+    }
+  });
+
+  auto start = std::chrono::steady_clock::now();
+
+  size_t value;
+  for (size_t i = 0; i < roundTrips; ++i) {
+    while ( ! ping.tryPush(i)) {}
+    while ( ! pong.tryPop(value)) {}
+  }
+
+  std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+  echo.join();
+  return elapsed.count() / roundTrips / 2;
+}
+
+TEST_CASE("Queue throughput and latency", "[.][benchmark]")
+{
+  const size_t items = 5'000'000;
+
+  WARN("1 pair, SpscQueue:  " << measureThroughput<SpscQueue<size_t>>(1, items) / 1e6 << " M items/s");
+
+  for (size_t pairs = 1; pairs <= 8; pairs *= 2) {
+    WARN(pairs << " pair(s), MpmcQueue:  " << measureThroughput<MpmcQueue<size_t>>(pairs, items / pairs) / 1e6 << " M items/s");
+    WARN(pairs << " pair(s), MutexQueue: " << measureThroughput<MutexQueue<size_t>>(pairs, items / pairs) / 1e6 << " M items/s");
+  }
+
+  const size_t roundTrips = 200'000;
+  WARN("Latency, SpscQueue:  " << measureLatency<SpscQueue<size_t>>(roundTrips) << " ns");
+  WARN("Latency, MpmcQueue:  " << measureLatency<MpmcQueue<size_t>>(roundTrips) << " ns");
+  WARN("Latency, MutexQueue: " << measureLatency<MutexQueue<size_t>>(roundTrips) << " ns");
+}
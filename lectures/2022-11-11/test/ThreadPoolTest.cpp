@@ -0,0 +1,65 @@
+#include "catch2/catch_all.hpp"
+
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("ThreadPool::threadCount() includes the calling thread", "[ThreadPool]")
+{
+  ThreadPool pool(3);
+  CHECK(pool.threadCount() == 3);
+}
+
+TEST_CASE("ThreadPool::run() executes each task exactly once", "[ThreadPool]")
+{
+  const size_t threads = GENERATE(1, 2, 4);
+  ThreadPool pool(threads);
+
+  const size_t count = 1000;
+  std::vector<std::atomic<int>> executed(count);
+
+  // Run several batches to check that the workers are reused correctly
+  for (int batch = 1; batch <= 3; ++batch) {
+    pool.run(count, [&](size_t i) { ++executed[i]; });
+
+    for (size_t i = 0; i < count; ++i)
+      REQUIRE(executed[i] == batch);
+  }
+}
+
+TEST_CASE("ThreadPool::run() does nothing when there are no tasks", "[ThreadPool]")
+{
+  ThreadPool pool(2);
+  bool called = false;
+  pool.run(0, [&](size_t) { called = true; });
+  CHECK_FALSE(called);
+}
+
+TEST_CASE("ThreadPool::run() rethrows exceptions thrown by tasks", "[ThreadPool]")
+{
+  ThreadPool pool(4);
+
+  CHECK_THROWS_AS(
+    pool.run(100, [](size_t i) { if (i == 42) throw std::runtime_error("failed"); }),
+    std::runtime_error);
+
+  SECTION("The pool remains usable after an exception") {
+    std::atomic<size_t> executed{0};
+    pool.run(100, [&](size_t) { ++executed; });
+    CHECK(executed == 100);
+  }
+}
+
+TEST_CASE("ThreadPool::run() can be called from inside a task", "[ThreadPool]")
+{
+  ThreadPool pool(4);
+  std::atomic<size_t> executed{0};
+
+  pool.run(10, [&](size_t) {
+    pool.run(10, [&](size_t) { ++executed; });
+  });
+
+  CHECK(executed == 100);
+}
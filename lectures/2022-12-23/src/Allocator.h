@@ -1,14 +1,30 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
 #include <unordered_set>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 template <typename T>
 class SimpleAllocator {
 public: 
-    T* buy()
+    /// Tells containers that buy() and release() can be called from several threads at once
+    static constexpr bool threadSafe = true;
+
+    /// Creates a new object, passing `args` to its constructor
+    template <typename... Args>
+    T* buy(Args&&... args)
     {
-        return new T();
+        return new T(std::forward<Args>(args)...);
     }
 
     void release(T* ptr)
@@ -23,9 +39,10 @@ class DebugAllocator {
     size_t totalAllocations = 0;
 
 public:
-    T* buy()
+    template <typename... Args>
+    T* buy(Args&&... args)
     {
-        T* newItem = new T();
+        T* newItem = new T(std::forward<Args>(args)...);
         ++totalAllocations;
         return *allocations.insert(newItem).first;
     }
@@ -38,8 +55,8 @@ public:
         if(allocations.count(ptr) == 0)
             throw std::invalid_argument("Trying to release a pointer not returned by this allocator");
 
-        delete ptr;
         allocations.erase(ptr);
+        delete ptr;
     }
 
     size_t allocationsCount() const noexcept
@@ -51,4 +68,872 @@ public:
     {
         return totalAllocations;
     }
-};
\ No newline at end of file
+};
+
+///
+/// Checks the use of allocated objects like DebugAllocator, but without its per-object overhead
+///
+/// Objects are allocated from slabs, which are aligned to their own size.
+/// The slab of an object is found by rounding its address down and each slab
+/// begins with a bitmap, which has one bit per object and tells whether it is allocated.
+/// Thus checking a pointer only takes a lookup of its slab in a hash set
+/// and a test of one bit. Released objects are recycled through a free list.
+/// Memory is allocated only when a new slab is needed.
+///
+/// Objects, which are still allocated when the allocator is destroyed,
+/// are not destructed.
+///
+template <typename T>
+class TrackingAllocator {
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    using Word = std::uint64_t;
+    static constexpr size_t BitsPerWord = 64;
+
+    /// The smallest power of two, which is at least 64 KiB and holds at least 64 objects
+    static constexpr size_t computeSlabBytes()
+    {
+        size_t bytes = 64 * 1024;
+        while(bytes < 64 * sizeof(Slot) + sizeof(Word) + alignof(Slot))
+            bytes *= 2;
+        return bytes;
+    }
+
+    /// Size of the bitmap for a given number of objects, rounded up to the alignment of the objects
+    static constexpr size_t headerBytes(size_t slots)
+    {
+        const size_t bytes = (slots + BitsPerWord - 1) / BitsPerWord * sizeof(Word);
+        return (bytes + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot);
+    }
+
+    static constexpr size_t computeSlotsPerSlab()
+    {
+        size_t slots = computeSlabBytes() / sizeof(Slot);
+        while(headerBytes(slots) + slots * sizeof(Slot) > computeSlabBytes())
+            --slots;
+        return slots;
+    }
+
+public:
+    /// Size and alignment of each slab
+    static constexpr size_t SlabBytes = computeSlabBytes();
+
+    /// Number of objects in each slab
+    static constexpr size_t SlotsPerSlab = computeSlotsPerSlab();
+
+private:
+    static constexpr size_t BitmapWords = (SlotsPerSlab + BitsPerWord - 1) / BitsPerWord;
+    static constexpr size_t SlotsOffset = headerBytes(SlotsPerSlab);
+
+    std::unordered_set<std::uintptr_t> slabs;
+    Slot* freeList = nullptr;
+    size_t allocations = 0;
+    size_t totalAllocations = 0;
+
+public:
+    TrackingAllocator() = default;
+
+    TrackingAllocator(const TrackingAllocator&) = delete;
+    TrackingAllocator& operator=(const TrackingAllocator&) = delete;
+
+    ~TrackingAllocator()
+    {
+        for(std::uintptr_t base : slabs)
+            std::free(reinterpret_cast<void*>(base));
+    }
+
+    template <typename... Args>
+    T* buy(Args&&... args)
+    {
+        if( ! freeList )
+            addSlab();
+
+        Slot* slot = freeList;
+        freeList = slot->next;
+
+        T* result;
+        try {
+            result = new (slot->storage) T(std::forward<Args>(args)...);
+        }
+        catch(...) {
+            slot->next = freeList;
+            freeList = slot;
+            throw;
+        }
+
+        const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(slot);
+        const std::uintptr_t base = address & ~(SlabBytes - 1);
+        const size_t index = (address - base - SlotsOffset) / sizeof(Slot);
+        bitmap(base)[index / BitsPerWord] |= Word(1) << (index % BitsPerWord);
+
+        ++allocations;
+        ++totalAllocations;
+        return result;
+    }
+
+    void release(T* ptr)
+    {
+        if( ! ptr ) // do nothing when ptr == nullptr
+            return;
+
+        const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(ptr);
+        const std::uintptr_t base = address & ~(SlabBytes - 1);
+        const size_t offset = address - base;
+
+        if(slabs.count(base) == 0 || offset < SlotsOffset || (offset - SlotsOffset) % sizeof(Slot) != 0)
+            throw std::invalid_argument("Trying to release a pointer not returned by this allocator");
+
+        const size_t index = (offset - SlotsOffset) / sizeof(Slot);
+        if(index >= SlotsPerSlab)
+            throw std::invalid_argument("Trying to release a pointer not returned by this allocator");
+
+        Word& word = bitmap(base)[index / BitsPerWord];
+        const Word mask = Word(1) << (index % BitsPerWord);
+
+        if((word & mask) == 0)
+            throw std::invalid_argument("Trying to release a pointer, which is not currently allocated");
+
+        word &= ~mask;
+        ptr->~T();
+
+        Slot* slot = reinterpret_cast<Slot*>(ptr);
+        slot->next = freeList;
+        freeList = slot;
+        --allocations;
+    }
+
+    size_t allocationsCount() const noexcept
+    {
+        return allocations;
+    }
+
+    size_t totalAllocationsCount() const noexcept
+    {
+        return totalAllocations;
+    }
+
+private:
+    static Word* bitmap(std::uintptr_t base) noexcept
+    {
+        return reinterpret_cast<Word*>(base);
+    }
+
+    void addSlab()
+    {
+        void* memory = std::aligned_alloc(SlabBytes, SlabBytes);
+        if( ! memory )
+            throw std::bad_alloc();
+
+        const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(memory);
+
+        try {
+            slabs.insert(base);
+        }
+        catch(...) {
+            std::free(memory);
+            throw;
+        }
+
+        std::uninitialized_fill_n(bitmap(base), BitmapWords, Word(0));
+
+        Slot* slots = reinterpret_cast<Slot*>(base + SlotsOffset);
+        for(size_t i = SlotsPerSlab; i > 0; --i) {
+            slots[i - 1].next = freeList;
+            freeList = &slots[i - 1];
+        }
+    }
+};
+
+///
+/// Allocates objects from slabs and recycles released objects through a free list
+///
+/// Each slab holds several objects, so most calls to buy() and release() only
+/// take or put an object at the head of the free list, without calling new or delete.
+/// The link of the free list is stored in the memory of the released object itself.
+/// Slabs are freed by trim(), once none of their objects is allocated,
+/// or when the allocator is destroyed.
+///
+/// buyBlock() allocates several objects in a single contiguous slab, which lets
+/// containers relocate their elements next to each other (see BinarySearchTree::compact()).
+///
+/// Objects, which are still allocated when the allocator is destroyed,
+/// are not destructed.
+///
+template <typename T>
+class PoolAllocator {
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    struct Slab {
+        std::unique_ptr<Slot[]> slots;
+        size_t size = 0;
+    };
+
+    std::vector<Slab> slabs;
+    Slot* freeList = nullptr;
+    size_t nextSlabSize = MinimalSlabSize;
+    size_t capacity = 0;
+    size_t allocations = 0;
+
+public:
+    /// Number of objects in the first slab. Each next slab is twice as large.
+    static constexpr size_t MinimalSlabSize = 16;
+
+    /// Slabs do not grow beyond this number of objects
+    static constexpr size_t MaximalSlabSize = 4096;
+
+    PoolAllocator() = default;
+
+    PoolAllocator(const PoolAllocator&) = delete;
+    PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+    template <typename... Args>
+    T* buy(Args&&... args)
+    {
+        if( ! freeList )
+            addSlab();
+
+        Slot* slot = freeList;
+        freeList = slot->next; // Read the link before the object overwrites it
+
+        try {
+            T* result = new (slot->storage) T(std::forward<Args>(args)...);
+            ++allocations;
+            return result;
+        }
+        catch(...) {
+            slot->next = freeList;
+            freeList = slot;
+            throw;
+        }
+    }
+
+    void release(T* ptr)
+    {
+        if( ! ptr ) // do nothing when ptr == nullptr
+            return;
+
+        ptr->~T();
+
+        Slot* slot = reinterpret_cast<Slot*>(ptr);
+        slot->next = freeList;
+        freeList = slot;
+        --allocations;
+    }
+
+    ///
+    /// Allocates `count` objects, which are stored next to each other
+    ///
+    /// The objects are placed in a new slab of their own. Each of them
+    /// is released separately with release().
+    ///
+    /// @return A pointer to the first object or nullptr if count is zero
+    /// @exception std::bad_alloc if memory allocation fails
+    ///
+    T* buyBlock(size_t count)
+    {
+        static_assert(sizeof(Slot) == sizeof(T), "The objects in a block must be adjacent, so T must be at least as large as a pointer");
+
+        if(count == 0)
+            return nullptr;
+
+        slabs.reserve(slabs.size() + 1);
+        Slab slab { std::make_unique<Slot[]>(count), count };
+        T* result = reinterpret_cast<T*>(slab.slots[0].storage);
+
+        size_t constructed = 0;
+        try {
+            for(; constructed < count; ++constructed)
+                new (slab.slots[constructed].storage) T();
+        }
+        catch(...) {
+            for(size_t i = 0; i < constructed; ++i)
+                reinterpret_cast<T*>(slab.slots[i].storage)->~T();
+            throw;
+        }
+
+        slabs.push_back(std::move(slab));
+        capacity += count;
+        allocations += count;
+        return result;
+    }
+
+    ///
+    /// Frees the slabs, none of whose objects are allocated
+    ///
+    /// Takes O(F log S) time for F free objects and S slabs.
+    ///
+    void trim()
+    {
+        std::sort(slabs.begin(), slabs.end(), [](const Slab& a, const Slab& b) {
+            return std::less<Slot*>()(a.slots.get(), b.slots.get());
+        });
+
+        std::vector<size_t> freeCount(slabs.size(), 0);
+        for(Slot* slot = freeList; slot; slot = slot->next)
+            ++freeCount[slabOf(slot)];
+
+        // Rebuild the free list, skipping the objects of the slabs which will be freed
+        Slot* kept = nullptr;
+        for(Slot* slot = freeList; slot; ) {
+            Slot* next = slot->next;
+            const size_t slab = slabOf(slot);
+            if(freeCount[slab] != slabs[slab].size) {
+                slot->next = kept;
+                kept = slot;
+            }
+            slot = next;
+        }
+        freeList = kept;
+
+        size_t remaining = 0;
+        for(size_t i = 0; i < slabs.size(); ++i) {
+            if(freeCount[i] == slabs[i].size)
+                capacity -= slabs[i].size;
+            else
+                slabs[remaining++] = std::move(slabs[i]);
+        }
+        slabs.resize(remaining);
+    }
+
+    /// Number of objects, which are currently allocated
+    size_t allocationsCount() const noexcept
+    {
+        return allocations;
+    }
+
+    /// Number of objects, which can be allocated before a new slab is needed
+    size_t capacityCount() const noexcept
+    {
+        return capacity;
+    }
+
+private:
+    void addSlab()
+    {
+        const size_t size = nextSlabSize;
+        slabs.reserve(slabs.size() + 1);
+        slabs.push_back(Slab { std::make_unique<Slot[]>(size), size });
+        Slot* slab = slabs.back().slots.get();
+
+        for(size_t i = 0; i < size; ++i)
+            slab[i].next = (i + 1 < size) ? &slab[i + 1] : freeList;
+
+        freeList = slab;
+        capacity += size;
+        nextSlabSize = std::min(nextSlabSize * 2, MaximalSlabSize);
+    }
+
+    /// Index of the slab, which contains a slot. The slabs must be sorted by address.
+    size_t slabOf(Slot* slot) const
+    {
+        auto it = std::upper_bound(slabs.begin(), slabs.end(), slot, [](Slot* ptr, const Slab& slab) {
+            return std::less<Slot*>()(ptr, slab.slots.get());
+        });
+        return static_cast<size_t>(it - slabs.begin()) - 1;
+    }
+};
+
+///
+/// Allocates objects by advancing a pointer in a chunk of memory
+///
+/// release() does nothing. The memory of all objects is reclaimed at once by reset()
+/// or when the allocator is destroyed. This suits containers, which are built,
+/// used and then discarded as a whole. Objects released one by one (e.g. by erasing
+/// from a tree) keep occupying memory until the next reset().
+///
+template <typename T>
+class ArenaAllocator {
+    union Slot {
+        Slot() {}
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    struct Chunk {
+        std::unique_ptr<Slot[]> slots;
+        size_t size = 0;
+        size_t used = 0;
+    };
+
+    std::vector<Chunk> chunks;
+    size_t totalAllocations = 0;
+
+public:
+    /// Tells containers that release() does not reclaim memory and reset() reclaims all of it
+    static constexpr bool releasesInBulk = true;
+
+    /// Number of objects in the first chunk. Each next chunk is twice as large.
+    static constexpr size_t MinimalChunkSize = 64;
+
+    /// Chunks do not grow beyond this number of objects
+    static constexpr size_t MaximalChunkSize = 64 * 1024;
+
+    ArenaAllocator() = default;
+
+    ArenaAllocator(const ArenaAllocator&) = delete;
+    ArenaAllocator& operator=(const ArenaAllocator&) = delete;
+
+    ~ArenaAllocator()
+    {
+        reset();
+    }
+
+    template <typename... Args>
+    T* buy(Args&&... args)
+    {
+        if(chunks.empty() || chunks.back().used == chunks.back().size)
+            addChunk();
+
+        Chunk& chunk = chunks.back();
+        T* result = new (chunk.slots[chunk.used].storage) T(std::forward<Args>(args)...);
+        ++chunk.used;
+        ++totalAllocations;
+        return result;
+    }
+
+    /// Does nothing. The object is destroyed by reset().
+    void release(T*) noexcept
+    {
+    }
+
+    /// Destroys all objects obtained from the allocator and frees their memory
+    void reset() noexcept
+    {
+        if constexpr ( ! std::is_trivially_destructible_v<T> ) {
+            for(Chunk& chunk : chunks) {
+                for(size_t i = 0; i < chunk.used; ++i)
+                    reinterpret_cast<T*>(chunk.slots[i].storage)->~T();
+            }
+        }
+
+        chunks.clear();
+        totalAllocations = 0;
+    }
+
+    /// Number of objects obtained from the allocator since the last reset()
+    size_t totalAllocationsCount() const noexcept
+    {
+        return totalAllocations;
+    }
+
+private:
+    void addChunk()
+    {
+        const size_t size = chunks.empty() ? MinimalChunkSize : std::min(chunks.back().size * 2, MaximalChunkSize);
+        chunks.reserve(chunks.size() + 1);
+
+        Chunk chunk;
+        chunk.slots = std::unique_ptr<Slot[]>(new Slot[size]);
+        chunk.size = size;
+        chunks.push_back(std::move(chunk));
+    }
+};
+
+///
+/// Tells whether an allocator reclaims all of its memory at once with reset(),
+/// so that containers can skip releasing their elements one by one
+///
+template <typename AllocatorType, typename = void>
+struct ReleasesInBulk : std::false_type {};
+
+template <typename AllocatorType>
+struct ReleasesInBulk<AllocatorType, std::void_t<decltype(AllocatorType::releasesInBulk)>>
+    : std::bool_constant<AllocatorType::releasesInBulk> {};
+
+///
+/// Tells whether an allocator can allocate several adjacent objects at once with buyBlock(n)
+///
+template <typename AllocatorType, typename = void>
+struct BuysInBlocks : std::false_type {};
+
+template <typename AllocatorType>
+struct BuysInBlocks<AllocatorType, std::void_t<decltype(std::declval<AllocatorType&>().buyBlock(size_t()))>>
+    : std::true_type {};
+
+///
+/// Tells whether an allocator can be used by several threads at the same time
+///
+template <typename AllocatorType, typename = void>
+struct IsThreadSafe : std::false_type {};
+
+template <typename AllocatorType>
+struct IsThreadSafe<AllocatorType, std::void_t<decltype(AllocatorType::threadSafe)>>
+    : std::bool_constant<AllocatorType::threadSafe> {};
+
+///
+/// Allocates objects from per-thread caches, which exchange batches with a shared depot
+///
+/// Each thread keeps a free list of its own, so buy() and release() normally
+/// do not synchronize with other threads. When a cache runs empty, it takes a batch
+/// of free objects from the depot (or the depot allocates a new slab). When a cache
+/// grows too large, it gives a batch back. Only these exchanges lock the depot's mutex.
+///
+/// An object may be released on a different thread than the one which bought it.
+/// It then simply becomes part of the releasing thread's cache.
+///
+/// All allocators for the same type T share the caches and the depot.
+/// The memory of the slabs is returned to the system only at program exit.
+///
+template <typename T>
+class ThreadCachingAllocator {
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    /// A linked list of free objects
+    struct Batch {
+        Slot* head = nullptr;
+        size_t count = 0;
+
+        void push(Slot* slot) noexcept
+        {
+            slot->next = head;
+            head = slot;
+            ++count;
+        }
+
+        Slot* pop() noexcept
+        {
+            Slot* slot = head;
+            head = head->next;
+            --count;
+            return slot;
+        }
+    };
+
+    class Depot {
+        std::mutex mutex;
+        std::vector<Batch> batches; // Full batches only
+        Batch partial; // Collects objects from incomplete batches
+        std::vector<std::unique_ptr<Slot[]>> slabs;
+
+    public:
+        Batch take()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            Batch result;
+
+            if( ! batches.empty() ) {
+                result = batches.back();
+                batches.pop_back();
+            }
+            else if(partial.count > 0) {
+                std::swap(result, partial);
+            }
+            else {
+                // Ensures put() does not need to allocate, as there are
+                // never more full batches than slabs
+                batches.reserve(slabs.size() + 1);
+                slabs.reserve(slabs.size() + 1);
+                slabs.push_back(std::make_unique<Slot[]>(BatchSize));
+
+                for(size_t i = 0; i < BatchSize; ++i)
+                    result.push(&slabs.back()[i]);
+            }
+
+            return result;
+        }
+
+        void put(Batch batch) noexcept
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            if(batch.count == BatchSize) {
+                batches.push_back(batch);
+                return;
+            }
+
+            while(batch.count > 0) {
+                partial.push(batch.pop());
+                if(partial.count == BatchSize) {
+                    batches.push_back(partial);
+                    partial = Batch();
+                }
+            }
+        }
+    };
+
+    class Cache {
+        Depot& depot = sharedDepot(); // Constructed first, so that it outlives the cache
+
+    public:
+        Batch freeList;
+
+        ~Cache()
+        {
+            while(freeList.count > 0)
+                depot.put(split());
+        }
+
+        void refill()
+        {
+            freeList = depot.take();
+        }
+
+        void trim() noexcept
+        {
+            if(freeList.count >= 2 * BatchSize)
+                depot.put(split());
+        }
+
+    private:
+        /// Removes at most BatchSize objects from the free list
+        Batch split() noexcept
+        {
+            Batch result;
+            while(result.count < BatchSize && freeList.count > 0)
+                result.push(freeList.pop());
+            return result;
+        }
+    };
+
+    std::atomic<size_t> allocations{0};
+
+public:
+    /// @copydoc SimpleAllocator::threadSafe
+    static constexpr bool threadSafe = true;
+
+    /// Number of objects exchanged between a thread cache and the depot at once
+    static constexpr size_t BatchSize = 64;
+
+    ThreadCachingAllocator() = default;
+
+    ThreadCachingAllocator(const ThreadCachingAllocator&) = delete;
+    ThreadCachingAllocator& operator=(const ThreadCachingAllocator&) = delete;
+
+    template <typename... Args>
+    T* buy(Args&&... args)
+    {
+        Cache& cache = localCache();
+
+        if(cache.freeList.count == 0)
+            cache.refill();
+
+        Slot* slot = cache.freeList.pop();
+
+        try {
+            T* result = new (slot->storage) T(std::forward<Args>(args)...);
+            allocations.fetch_add(1, std::memory_order_relaxed);
+            return result;
+        }
+        catch(...) {
+            cache.freeList.push(slot);
+            throw;
+        }
+    }
+
+    void release(T* ptr)
+    {
+        if( ! ptr ) // do nothing when ptr == nullptr
+            return;
+
+        ptr->~T();
+
+        Cache& cache = localCache();
+        cache.freeList.push(reinterpret_cast<Slot*>(ptr));
+        cache.trim();
+        allocations.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /// Number of objects, which are currently allocated by this allocator
+    size_t allocationsCount() const noexcept
+    {
+        return allocations.load(std::memory_order_relaxed);
+    }
+
+private:
+    static Depot& sharedDepot()
+    {
+        static Depot depot;
+        return depot;
+    }
+
+    static Cache& localCache()
+    {
+        static thread_local Cache cache;
+        return cache;
+    }
+};
+
+///
+/// Allocates objects from a lock-free stack of free objects, which can be shared by any number of threads
+///
+/// The free objects form a Treiber stack. Its head packs the 32-bit index of the top
+/// object together with a 32-bit tag, which is incremented on every change. A thread,
+/// which was preempted between reading the head and swapping it, fails its compare-and-swap
+/// even if the same object is on top again, which prevents the ABA problem.
+///
+/// When the stack is empty, the thread that notices it claims the next slab with an atomic
+/// counter, keeps one object and pushes the rest. Slabs have a fixed size, so that several
+/// threads growing the allocator at the same time allocate at most one slab each.
+/// The slabs are found through a two-level table, whose second level is created on demand.
+///
+/// Objects, which are still allocated when the allocator is destroyed,
+/// are not destructed.
+///
+template <typename T>
+class LockFreeAllocator {
+    struct Slot {
+        alignas(T) unsigned char storage[sizeof(T)]; // First, so that a T* is also a Slot*
+        std::atomic<std::uint32_t> next{0};
+        std::uint32_t index = 0;
+    };
+
+    static constexpr std::uint32_t NullIndex = 0xFFFFFFFF;
+    static constexpr std::uint64_t IndexMask = 0xFFFFFFFF;
+
+public:
+    /// Number of objects in each slab
+    static constexpr size_t SlabSize = 4096;
+
+    /// Number of slab pointers in each second-level table
+    static constexpr size_t SlabsPerTable = 4096;
+
+    /// Maximal number of slabs. The last index is reserved for marking the end of the stack.
+    static constexpr size_t MaximalSlabCount = (size_t(1) << 32) / SlabSize - 1;
+
+private:
+    struct SlabTable {
+        std::atomic<Slot*> slabs[SlabsPerTable] = {};
+    };
+
+    std::atomic<std::uint64_t> head{NullIndex};
+    std::atomic<SlabTable*> tables[(MaximalSlabCount + SlabsPerTable) / SlabsPerTable] = {};
+    std::atomic<size_t> slabCount{0};
+    std::atomic<size_t> allocations{0};
+
+public:
+    /// @copydoc SimpleAllocator::threadSafe
+    static constexpr bool threadSafe = true;
+
+    LockFreeAllocator() = default;
+
+    LockFreeAllocator(const LockFreeAllocator&) = delete;
+    LockFreeAllocator& operator=(const LockFreeAllocator&) = delete;
+
+    ~LockFreeAllocator()
+    {
+        for(std::atomic<SlabTable*>& table : tables) {
+            SlabTable* slabs = table.load(std::memory_order_relaxed);
+            if( ! slabs )
+                continue;
+
+            for(std::atomic<Slot*>& slab : slabs->slabs)
+                delete[] slab.load(std::memory_order_relaxed);
+
+            delete slabs;
+        }
+    }
+
+    template <typename... Args>
+    T* buy(Args&&... args)
+    {
+        Slot* slot = pop();
+
+        if( ! slot )
+            slot = addSlab();
+
+        try {
+            T* result = new (slot->storage) T(std::forward<Args>(args)...);
+            allocations.fetch_add(1, std::memory_order_relaxed);
+            return result;
+        }
+        catch(...) {
+            push(slot, slot);
+            throw;
+        }
+    }
+
+    void release(T* ptr)
+    {
+        if( ! ptr ) // do nothing when ptr == nullptr
+            return;
+
+        ptr->~T();
+
+        Slot* slot = reinterpret_cast<Slot*>(ptr);
+        push(slot, slot);
+        allocations.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /// Number of objects, which are currently allocated
+    size_t allocationsCount() const noexcept
+    {
+        return allocations.load(std::memory_order_relaxed);
+    }
+
+private:
+    Slot& slotAt(std::uint32_t index) const noexcept
+    {
+        const size_t slab = index / SlabSize;
+        const SlabTable& table = *tables[slab / SlabsPerTable].load(std::memory_order_acquire);
+        return table.slabs[slab % SlabsPerTable].load(std::memory_order_acquire)[index % SlabSize];
+    }
+
+    Slot* pop() noexcept
+    {
+        std::uint64_t top = head.load(std::memory_order_acquire);
+
+        for(;;) {
+            const std::uint32_t index = static_cast<std::uint32_t>(top & IndexMask);
+            if(index == NullIndex)
+                return nullptr;
+
+            Slot& slot = slotAt(index);
+            const std::uint32_t next = slot.next.load(std::memory_order_relaxed);
+            const std::uint64_t newTop = (((top >> 32) + 1) << 32) | next;
+
+            if(head.compare_exchange_weak(top, newTop, std::memory_order_acquire, std::memory_order_acquire))
+                return &slot;
+        }
+    }
+
+    /// Pushes a chain of objects, which are already linked from first to last
+    void push(Slot* first, Slot* last) noexcept
+    {
+        std::uint64_t top = head.load(std::memory_order_relaxed);
+        std::uint64_t newTop;
+
+        do {
+            last->next.store(static_cast<std::uint32_t>(top & IndexMask), std::memory_order_relaxed);
+            newTop = (((top >> 32) + 1) << 32) | first->index;
+        } while( ! head.compare_exchange_weak(top, newTop, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    /// Allocates a new slab, keeps its first object and pushes the others to the stack
+    Slot* addSlab()
+    {
+        const size_t k = slabCount.fetch_add(1, std::memory_order_relaxed);
+        if(k >= MaximalSlabCount)
+            throw std::bad_alloc();
+
+        std::atomic<SlabTable*>& table = tables[k / SlabsPerTable];
+        SlabTable* slabs = table.load(std::memory_order_acquire);
+
+        if( ! slabs ) {
+            SlabTable* created = new SlabTable();
+            if(table.compare_exchange_strong(slabs, created, std::memory_order_acq_rel, std::memory_order_acquire))
+                slabs = created;
+            else
+                delete created; // Another thread was faster and slabs now points to its table
+        }
+
+        Slot* slab = new Slot[SlabSize];
+
+        for(size_t i = 0; i < SlabSize; ++i) {
+            slab[i].index = static_cast<std::uint32_t>(k * SlabSize + i);
+            slab[i].next.store(slab[i].index + 1, std::memory_order_relaxed);
+        }
+
+        slabs->slabs[k % SlabsPerTable].store(slab, std::memory_order_release);
+        push(&slab[1], &slab[SlabSize - 1]);
+
+        return &slab[0];
+    }
+};
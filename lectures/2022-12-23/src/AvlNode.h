@@ -0,0 +1,83 @@
+#pragma once
+
+#include <algorithm>
+#include <utility>
+
+///
+/// A tree node, which also stores the height of its subtree
+///
+/// Used by AvlNodeOperations to keep the tree balanced. For small types
+/// the height fits in the padding after `data`, so an AvlNode<int>
+/// takes as much memory as a Node<int>.
+///
+template <typename T>
+class AvlNode {
+public:
+    /// How other nodes refer to a node
+    using Handle = AvlNode*;
+    using ConstHandle = const AvlNode*;
+
+    T data = T();
+
+    /// Height of the subtree rooted at this node. A leaf has height 1.
+    int height = 1;
+
+    AvlNode* left = nullptr;
+    AvlNode* right = nullptr;
+
+    AvlNode()
+    {
+    }
+
+    AvlNode(const T& data)
+        : data(data)
+    {
+    }
+
+    AvlNode(T&& data)
+        : data(std::move(data))
+    {
+    }
+
+    /// @copydoc Node::Node(std::in_place_t, Args&&...)
+    template <typename... Args>
+    explicit AvlNode(std::in_place_t, Args&&... args)
+        : data(std::forward<Args>(args)...)
+    {
+    }
+
+    bool isLeaf() const noexcept
+    {
+        return left == nullptr && right == nullptr;
+    }
+
+    bool hasLeftSuccessor() const noexcept
+    {
+        return left != nullptr;
+    }
+
+    bool hasRightSuccessor() const noexcept
+    {
+        return right != nullptr;
+    }
+
+    /// @copydoc Node::whichSuccessorWouldStore
+    AvlNode*& whichSuccessorWouldStore(const T& value)
+    {
+        return (value < data) ? left : right;
+    }
+
+    /// Set both successor pointers to null, effectively making this node a leaf
+    void detachSuccessors()
+    {
+        left = nullptr;
+        right = nullptr;
+        height = 1;
+    }
+
+    /// Recomputes the height from the heights of the successors
+    void update() noexcept
+    {
+        height = 1 + std::max(left ? left->height : 0, right ? right->height : 0);
+    }
+};
@@ -0,0 +1,311 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#include "AvlNode.h"
+#include "NodeOperations.h"
+
+///
+/// BST operations, which keep the tree balanced as an AVL tree
+///
+/// After each insertion and extraction the heights of the two subtrees
+/// of every node differ by at most one, which is restored with rotations
+/// on the path to the changed node. The height of a tree with n nodes
+/// is therefore below 1.45 log2(n + 2), even for sorted input.
+///
+/// The operations, which do not change the shape of the tree, are shared
+/// with IterativeNodeOperations. To use the policy, the allocator must
+/// provide AvlNode objects, e.g.:
+///
+///     BinarySearchTree<int, PoolAllocator<AvlNode<int>>, AvlNodeOperations<int>>
+///
+/// Other node types can be used, if they have a `height` member and an update()
+/// function, which recomputes it (and any other data kept about the subtree)
+/// from the successors, e.g. OrderStatisticNode.
+///
+template <typename T, typename NodeT = AvlNode<T>>
+class AvlNodeOperations : public IterativeNodeOperations<T, NodeT> {
+public:
+    using NodeType = NodeT;
+    using Handle = typename NodeType::Handle;
+    using ConstHandle = typename NodeType::ConstHandle;
+
+    /// Height of a subtree. An empty subtree has height 0.
+    static int height(ConstHandle node) noexcept
+    {
+        return node ? node->height : 0;
+    }
+
+    ///
+    /// Inserts a node in a tree and rebalances it
+    ///
+    /// `node` itself will be inserted and no copy will be created.
+    /// Duplicate values are placed in the right subtree of their equals.
+    ///
+    static void insert(Handle& rootptr, Handle node)
+    {
+        if( ! rootptr ) {
+            node->detachSuccessors();
+            rootptr = node;
+            return;
+        }
+
+        insert(rootptr->whichSuccessorWouldStore(node->data), node);
+        rebalance(rootptr);
+    }
+
+    /// @copydoc AvlNodeOperations::insert
+    static void insert(Handle& rootptr, NodeType& node)
+    {
+        insert(rootptr, &node);
+    }
+
+    ///
+    /// Extracts a node with a given value from a tree and rebalances it
+    ///
+    /// @return The extracted node, or nullptr if no node contains `value`.
+    ///     The node is detached from the tree, but not released.
+    ///
+    static Handle extract(Handle& rootptr, const T& value)
+    {
+        if( ! rootptr )
+            return nullptr;
+
+        Handle result = nullptr;
+
+        if(rootptr->data == value) {
+            result = rootptr;
+
+            if( ! result->left ) {
+                rootptr = result->right;
+            }
+            else if( ! result->right ) {
+                rootptr = result->left;
+            }
+            else {
+                Handle promoted = extractLargest(result->left);
+                promoted->left = result->left;
+                promoted->right = result->right;
+                rootptr = promoted;
+            }
+
+            result->detachSuccessors();
+        }
+        else {
+            result = extract(rootptr->whichSuccessorWouldStore(value), value);
+        }
+
+        if(rootptr && result)
+            rebalance(rootptr);
+
+        return result;
+    }
+
+    ///
+    /// Creates a copy of a tree, including the heights of its nodes
+    ///
+    /// The recursion is as deep as the tree, which is logarithmic in its size.
+    /// @exception std::bad_alloc if memory allocation fails
+    ///
+    template <typename AllocatorType>
+    static Handle clone(Handle startFrom, AllocatorType& allocator)
+    {
+        if( ! startFrom )
+            return nullptr;
+
+        Handle result = allocator.buy(startFrom->data);
+
+        try {
+            result->left  = clone(startFrom->left, allocator);
+            result->right = clone(startFrom->right, allocator);
+        }
+        catch(std::bad_alloc&) {
+            AvlNodeOperations::release(result, allocator);
+            throw;
+        }
+
+        result->update();
+        return result;
+    }
+
+    /// @copydoc IterativeNodeOperations::fromSortedList
+    static Handle fromSortedList(Handle list, size_t size)
+    {
+        Handle root = IterativeNodeOperations<T, NodeT>::fromSortedList(list, size);
+        updateHeights(root);
+        return root;
+    }
+
+    ///
+    /// @copydoc RecursiveNodeOperations::split
+    ///
+    /// The nodes on the path are joined back into two AVL trees on the way up.
+    /// Each join takes time proportional to the difference of the heights of the
+    /// joined trees, so the whole split takes O(log n).
+    ///
+    static Handle split(Handle startFrom, const T& value, Handle& smaller, Handle& larger)
+    {
+        if( ! startFrom ) {
+            smaller = nullptr;
+            larger = nullptr;
+            return nullptr;
+        }
+
+        Handle left = startFrom->left;
+        Handle right = startFrom->right;
+        startFrom->detachSuccessors();
+
+        if(startFrom->data == value) {
+            smaller = left;
+            larger = right;
+            return startFrom;
+        }
+
+        Handle result = nullptr;
+
+        if(value < startFrom->data) {
+            result = split(left, value, smaller, left);
+            larger = join(left, startFrom, right);
+        }
+        else {
+            result = split(right, value, right, larger);
+            smaller = join(left, startFrom, right);
+        }
+
+        return result;
+    }
+
+    ///
+    /// Joins two AVL trees and a node, whose value lies between theirs, into one AVL tree
+    ///
+    /// `middle` is attached at the edge of the higher tree, where the subtree has about
+    /// the same height as the lower tree, and the path back up is rebalanced.
+    /// Takes O(|height(smaller) - height(larger)| + 1) time.
+    ///
+    static Handle join(Handle smaller, Handle middle, Handle larger)
+    {
+        const int difference = height(larger) - height(smaller);
+
+        if(difference > 1) {
+            larger->left = join(smaller, middle, larger->left);
+            rebalance(larger);
+            return larger;
+        }
+
+        if(difference < -1) {
+            smaller->right = join(smaller->right, middle, larger);
+            rebalance(smaller);
+            return smaller;
+        }
+
+        middle->left = smaller;
+        middle->right = larger;
+        updateHeight(middle);
+        return middle;
+    }
+
+    ///
+    /// Joins two AVL trees, where all values in `smaller` are smaller than those in `larger`
+    ///
+    /// The largest node of `smaller` is extracted and used to join the rest.
+    ///
+    static Handle join(Handle smaller, Handle larger)
+    {
+        if( ! smaller )
+            return larger;
+
+        Handle middle = extractLargest(smaller);
+        return join(smaller, middle, larger);
+    }
+
+    ///
+    /// Checks whether a tree satisfies the AVL invariants
+    ///
+    /// Every node must store the correct height of its subtree and the heights
+    /// of the subtrees of a node must differ by at most one.
+    ///
+    static bool isBalanced(ConstHandle node)
+    {
+        if( ! node )
+            return true;
+
+        const int left = height(node->left);
+        const int right = height(node->right);
+
+        return node->height == 1 + std::max(left, right) &&
+               std::abs(left - right) <= 1 &&
+               isBalanced(node->left) &&
+               isBalanced(node->right);
+    }
+
+private:
+    static Handle extractLargest(Handle& rootptr)
+    {
+        if(rootptr->right) {
+            Handle result = extractLargest(rootptr->right);
+            rebalance(rootptr);
+            return result;
+        }
+
+        Handle result = rootptr;
+        rootptr = result->left;
+        return result;
+    }
+
+    /// Updates the heights of all nodes of a balanced tree, bottom-up. The recursion is as deep as the tree.
+    static void updateHeights(Handle node) noexcept
+    {
+        if( ! node )
+            return;
+
+        updateHeights(node->left);
+        updateHeights(node->right);
+        node->update();
+    }
+
+    static void updateHeight(Handle node) noexcept
+    {
+        node->update();
+    }
+
+    static void rotateLeft(Handle& rootptr) noexcept
+    {
+        Handle promoted = rootptr->right;
+        rootptr->right = promoted->left;
+        promoted->left = rootptr;
+        updateHeight(rootptr);
+        updateHeight(promoted);
+        rootptr = promoted;
+    }
+
+    static void rotateRight(Handle& rootptr) noexcept
+    {
+        Handle promoted = rootptr->left;
+        rootptr->left = promoted->right;
+        promoted->right = rootptr;
+        updateHeight(rootptr);
+        updateHeight(promoted);
+        rootptr = promoted;
+    }
+
+    /// Restores the balance of a node, whose subtrees are balanced
+    /// and differ in height by at most two
+    static void rebalance(Handle& rootptr) noexcept
+    {
+        updateHeight(rootptr);
+        const int balance = height(rootptr->right) - height(rootptr->left);
+
+        if(balance > 1) {
+            if(height(rootptr->right->left) > height(rootptr->right->right))
+                rotateRight(rootptr->right);
+            rotateLeft(rootptr);
+        }
+        else if(balance < -1) {
+            if(height(rootptr->left->right) > height(rootptr->left->left))
+                rotateLeft(rootptr->left);
+            rotateRight(rootptr);
+        }
+    }
+};
@@ -0,0 +1,664 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "Allocator.h"
+
+// Keys of arithmetic types are compared with GCC vector extensions, other compilers use a scalar loop
+#if defined(__GNUC__) || defined(__clang__)
+#define BTREE_VECTOR_SEARCH
+#endif
+
+///
+/// A node of a BTree, which stores up to MaximalKeys sorted values
+///
+/// The number of values is chosen so that a node takes about `NodeBytes` bytes.
+/// The default is four cache lines, which lets a lookup read a whole node with
+/// a few adjacent memory accesses and keeps the tree shallow.
+/// All nodes, which are not leaves, have exactly `count + 1` children.
+///
+template <typename T, size_t NodeBytes = 256>
+class BTreeNode {
+public:
+    /// Each node except the root holds at least MinimumDegree - 1 values
+    static constexpr size_t MinimumDegree =
+        std::max<size_t>(2, (NodeBytes - sizeof(size_t) + sizeof(T)) / (2 * (sizeof(T) + sizeof(void*))));
+
+    /// Each node holds at most MaximalKeys values
+    static constexpr size_t MaximalKeys = 2 * MinimumDegree - 1;
+
+    size_t count = 0;
+    T keys[MaximalKeys] = {};
+    BTreeNode* children[MaximalKeys + 1] = {};
+
+    bool isLeaf() const noexcept
+    {
+        return children[0] == nullptr;
+    }
+
+    bool isFull() const noexcept
+    {
+        return count == MaximalKeys;
+    }
+
+    ///
+    /// Position of the first value, which is not less than `value`
+    ///
+    /// For arithmetic types the values smaller than `value` are counted without
+    /// branches, comparing 16 bytes of keys at once with GCC vector extensions.
+    /// For the few values in a cache-sized node this is faster than a binary search.
+    /// In larger nodes a binary search first narrows the range down to LinearSearchLimit values.
+    ///
+    size_t lowerBound(const T& value) const
+    {
+        if constexpr (std::is_arithmetic_v<T>) {
+            return searchLinearly<false>(value);
+        }
+        else {
+            return std::lower_bound(keys, keys + count, value) - keys;
+        }
+    }
+
+    /// Position of the first value, which is greater than `value`
+    size_t upperBound(const T& value) const
+    {
+        if constexpr (std::is_arithmetic_v<T>) {
+            return searchLinearly<true>(value);
+        }
+        else {
+            return std::upper_bound(keys, keys + count, value) - keys;
+        }
+    }
+
+private:
+    static constexpr size_t LinearSearchLimit = 32;
+
+    /// Whether `key` precedes the position returned by upperBound() (if Upper) or lowerBound()
+    template <bool Upper>
+    static bool isBefore(const T& key, const T& value)
+    {
+        if constexpr (Upper)
+            return ! (value < key);
+        else
+            return key < value;
+    }
+
+#if defined(BTREE_VECTOR_SEARCH)
+    /// bool and long double keys are only compared by the scalar loop
+    static constexpr bool Vectorizable = std::is_arithmetic_v<T> && ! std::is_same_v<T, bool> && sizeof(T) <= 8;
+
+    using Element = std::conditional_t<Vectorizable, T, int>;
+    typedef Element Vector __attribute__((vector_size(16)));
+
+    /// Number of keys in a vector
+    static constexpr size_t Width = sizeof(Vector) / sizeof(Element);
+#endif
+
+    /// Number of keys, for which `isBefore<Upper>(key, value)` holds. They precede all other keys.
+    template <bool Upper>
+    size_t searchLinearly(const T& value) const
+    {
+        size_t first = 0;
+        size_t last = count;
+
+        while(last - first > LinearSearchLimit) {
+            const size_t middle = first + (last - first) / 2;
+
+            if(isBefore<Upper>(keys[middle], value))
+                first = middle + 1;
+            else
+                last = middle;
+        }
+
+        size_t result = first;
+        size_t i = first;
+
+#if defined(BTREE_VECTOR_SEARCH)
+        if constexpr (Vectorizable) {
+            if(last - first >= Width) {
+                const Vector needle = Vector{} + value;
+
+                // Each lane of a comparison is -1 where it holds and 0 elsewhere.
+                // upperBound() counts the keys greater than `value`, so that NaNs
+                // are treated exactly as by the scalar loop.
+                decltype(needle < needle) matches{};
+                for(; i + Width <= last; i += Width) {
+                    Vector block;
+                    std::memcpy(&block, keys + i, sizeof(block));
+                    if constexpr (Upper)
+                        matches += needle < block;
+                    else
+                        matches += block < needle;
+                }
+
+                size_t matched = 0;
+                for(size_t j = 0; j < Width; ++j)
+                    matched -= matches[j];
+
+                result += Upper ? (i - first) - matched : matched;
+            }
+        }
+#endif
+
+        for(; i < last; ++i)
+            result += isBefore<Upper>(keys[i], value);
+
+        return result;
+    }
+};
+
+///
+/// An ordered container of values, which are stored in the nodes of a B-tree
+///
+/// Provides the same interface as BinarySearchTree. Each node holds many values,
+/// so a lookup visits O(log n / log MaximalKeys) nodes instead of O(log n) nodes
+/// and causes much fewer cache misses. Duplicate values are allowed.
+///
+/// Insertion and erasure work in a single pass from the root to a leaf,
+/// splitting full nodes and refilling minimal nodes on the way down.
+///
+/// @tparam NodeBytes Approximate size of a node in bytes
+/// @tparam AllocatorType Allocator of BTreeNode<ElementType, NodeBytes> objects
+///
+template <
+    typename ElementType,
+    size_t NodeBytes = 256,
+    typename AllocatorType = SimpleAllocator<BTreeNode<ElementType, NodeBytes>>
+    >
+class BTree {
+public:
+    using NodeType = BTreeNode<ElementType, NodeBytes>;
+
+private:
+    static constexpr size_t MinimumDegree = NodeType::MinimumDegree;
+
+    NodeType* m_rootptr = nullptr;
+    size_t m_size = 0;
+    AllocatorType m_allocator;
+
+public:
+    /// Upper bound of the number of levels in a tree. A tree with h levels holds at least
+    /// 2 * MinimumDegree^(h-1) - 1 values, so MinimumDegree^(h-1) cannot exceed SIZE_MAX.
+    static constexpr size_t maximalHeight() noexcept
+    {
+        size_t height = 1;
+        for(size_t power = 1; power <= SIZE_MAX / MinimumDegree; power *= MinimumDegree)
+            ++height;
+        return height;
+    }
+
+    class Iterator {
+        /// Path from the root to the current value. Each entry holds a node
+        /// and the position of the next value to visit in it. The path is stored
+        /// in the iterator itself, so iterating never allocates memory.
+        std::pair<const NodeType*, size_t> path[maximalHeight()];
+        size_t depth = 0;
+
+        void pushAllTheWayToTheLeft(const NodeType* node)
+        {
+            for(; node; node = node->children[0]) {
+                assert( depth < maximalHeight() );
+                path[depth++] = {node, 0};
+            }
+        }
+
+    public:
+        Iterator(const NodeType* startFrom)
+        {
+            pushAllTheWayToTheLeft(startFrom);
+        }
+
+        /// Copies only the used part of the path
+        Iterator(const Iterator& other)
+            : depth(other.depth)
+        {
+            std::copy(other.path, other.path + depth, path);
+        }
+
+        Iterator& operator=(const Iterator& other)
+        {
+            depth = other.depth;
+            std::copy(other.path, other.path + depth, path);
+            return *this;
+        }
+
+        const ElementType& operator*() const
+        {
+            assert( depth > 0 );
+            return path[depth - 1].first->keys[path[depth - 1].second];
+        }
+
+        const ElementType* operator->() const
+        {
+            return &operator*();
+        }
+
+        void operator++()
+        {
+            assert( depth > 0 );
+            auto& [node, position] = path[depth - 1];
+            const NodeType* next = node->children[++position];
+            pushAllTheWayToTheLeft(next);
+
+            while( depth > 0 && path[depth - 1].second == path[depth - 1].first->count )
+                --depth;
+        }
+
+        bool operator==(const Iterator& other) const
+        {
+            if(depth == 0 || other.depth == 0)
+                return depth == other.depth;
+
+            return path[depth - 1] == other.path[other.depth - 1];
+        }
+
+        bool operator!=(const Iterator& other) const
+        {
+            return ! operator==(other);
+        }
+    };
+
+public:
+    BTree() = default;
+
+    ~BTree()
+    {
+        clear();
+    }
+
+    BTree(const BTree& other)
+    {
+        m_rootptr = clone(other.m_rootptr);
+        m_size = other.m_size;
+    }
+
+    BTree& operator=(const BTree& other)
+    {
+        if(this != &other) {
+            clear();
+            m_rootptr = clone(other.m_rootptr);
+            m_size = other.m_size;
+        }
+        return *this;
+    }
+
+    /// @copydoc BinarySearchTree::clear
+    void clear()
+    {
+        if constexpr (ReleasesInBulk<AllocatorType>::value)
+            m_allocator.reset();
+        else
+            release(m_rootptr);
+
+        m_rootptr = nullptr;
+        m_size = 0;
+    }
+
+    size_t size() const noexcept
+    {
+        return m_size;
+    }
+
+    bool empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    const AllocatorType& allocator() const
+    {
+        return m_allocator;
+    }
+
+    bool contains(const ElementType& value) const
+    {
+        for(const NodeType* node = m_rootptr; node; ) {
+            const size_t position = node->lowerBound(value);
+
+            if(position < node->count && node->keys[position] == value)
+                return true;
+
+            node = node->children[position];
+        }
+
+        return false;
+    }
+
+    /// @exception std::bad_alloc if memory allocation fails. The value is not inserted,
+    ///     but some nodes may have been split already.
+    void insert(const ElementType& value)
+    {
+        // Copy before any node is changed, so that a throwing copy leaves the tree intact
+        ElementType copy(value);
+        insertValue(std::move(copy));
+    }
+
+    /// @copydoc insert(const ElementType&)
+    void insert(ElementType&& value)
+    {
+        insertValue(std::move(value));
+    }
+
+    /// Inserts a value constructed from `args`. The keys are stored in arrays in the nodes,
+    /// so the value is constructed once and then moved into its node.
+    template <typename... Args>
+    void emplace(Args&&... args)
+    {
+        insertValue(ElementType(std::forward<Args>(args)...));
+    }
+
+    /// Removes one occurrence of `value`, if it is present in the tree
+    void erase(const ElementType& value)
+    {
+        if( ! m_rootptr )
+            return;
+
+        if(eraseFrom(m_rootptr, value))
+            --m_size;
+
+        if(m_rootptr->count == 0) {
+            NodeType* oldRoot = m_rootptr;
+            m_rootptr = oldRoot->children[0];
+            m_allocator.release(oldRoot);
+        }
+    }
+
+    /// Checks whether two trees contain the same values
+    bool operator==(const BTree& other) const
+    {
+        if(m_size != other.m_size)
+            return false;
+
+        for(Iterator a = beginIterator(), b = other.beginIterator(); a != endIterator(); ++a, ++b) {
+            if(*a != *b)
+                return false;
+        }
+
+        return true;
+    }
+
+    Iterator beginIterator() const
+    {
+        return Iterator(m_rootptr);
+    }
+
+    Iterator endIterator() const
+    {
+        return Iterator(nullptr);
+    }
+
+    ///
+    /// Checks whether the tree satisfies the B-tree invariants
+    ///
+    /// All leaves must be at the same depth, every node except the root must hold
+    /// between MinimumDegree - 1 and MaximalKeys values, the values in each node
+    /// must be sorted and separate the values in its subtrees.
+    ///
+    bool isValid() const
+    {
+        int leafDepth = -1;
+        return ! m_rootptr || isValid(m_rootptr, 0, leafDepth, nullptr, nullptr);
+    }
+
+private:
+    /// Only moves the value and the keys, which must not throw, once the nodes are being changed
+    void insertValue(ElementType&& value)
+    {
+        static_assert(std::is_nothrow_move_assignable_v<ElementType>, "BTree requires a nothrow move assignment");
+
+        if( ! m_rootptr ) {
+            m_rootptr = m_allocator.buy();
+        }
+        else if(m_rootptr->isFull()) {
+            NodeType* root = m_allocator.buy();
+            root->children[0] = m_rootptr;
+
+            try {
+                splitChild(root, 0);
+            }
+            catch(...) {
+                m_allocator.release(root);
+                throw;
+            }
+
+            m_rootptr = root;
+        }
+
+        // The node we descend into is never full, so it can always accept one more value
+        NodeType* node = m_rootptr;
+
+        while( ! node->isLeaf() ) {
+            size_t position = node->upperBound(value);
+
+            if(node->children[position]->isFull()) {
+                splitChild(node, position);
+
+                if( ! (value < node->keys[position]) )
+                    ++position;
+            }
+
+            node = node->children[position];
+        }
+
+        const size_t position = node->upperBound(value);
+        std::move_backward(node->keys + position, node->keys + node->count, node->keys + node->count + 1);
+        node->keys[position] = std::move(value);
+        ++node->count;
+        ++m_size;
+    }
+
+    bool isValid(const NodeType* node, int depth, int& leafDepth, const ElementType* low, const ElementType* high) const
+    {
+        if(node != m_rootptr && node->count < MinimumDegree - 1)
+            return false;
+
+        if(node->count == 0 || node->count > NodeType::MaximalKeys)
+            return false;
+
+        for(size_t i = 0; i < node->count; ++i) {
+            if((low && node->keys[i] < *low) || (high && *high < node->keys[i]))
+                return false;
+            if(i > 0 && node->keys[i] < node->keys[i - 1])
+                return false;
+        }
+
+        if(node->isLeaf()) {
+            if(leafDepth < 0)
+                leafDepth = depth;
+            return leafDepth == depth && std::all_of(node->children, node->children + NodeType::MaximalKeys + 1, [](const NodeType* child) { return child == nullptr; });
+        }
+
+        for(size_t i = 0; i <= node->count; ++i) {
+            const ElementType* childLow = (i > 0) ? &node->keys[i - 1] : low;
+            const ElementType* childHigh = (i < node->count) ? &node->keys[i] : high;
+
+            if( ! node->children[i] || ! isValid(node->children[i], depth + 1, leafDepth, childLow, childHigh) )
+                return false;
+        }
+
+        return true;
+    }
+
+    /// Splits the full child at `position` in two and moves its middle value to `parent`
+    void splitChild(NodeType* parent, size_t position)
+    {
+        NodeType* left = parent->children[position];
+        NodeType* right = m_allocator.buy();
+
+        // The left node keeps the first MinimumDegree - 1 values
+        std::move(left->keys + MinimumDegree, left->keys + NodeType::MaximalKeys, right->keys);
+        std::copy(left->children + MinimumDegree, left->children + NodeType::MaximalKeys + 1, right->children);
+        std::fill(left->children + MinimumDegree, left->children + NodeType::MaximalKeys + 1, nullptr);
+        right->count = MinimumDegree - 1;
+        left->count = MinimumDegree - 1;
+
+        std::move_backward(parent->keys + position, parent->keys + parent->count, parent->keys + parent->count + 1);
+        std::copy_backward(parent->children + position + 1, parent->children + parent->count + 1, parent->children + parent->count + 2);
+        parent->keys[position] = std::move(left->keys[MinimumDegree - 1]);
+        parent->children[position + 1] = right;
+        ++parent->count;
+    }
+
+    ///
+    /// Removes one occurrence of `value` from the subtree of `node`
+    ///
+    /// `node` is either the root or holds at least MinimumDegree values,
+    /// so it can lose one value without becoming too small.
+    ///
+    bool eraseFrom(NodeType* node, const ElementType& value)
+    {
+        while(true) {
+            const size_t position = node->lowerBound(value);
+            const bool isHere = position < node->count && node->keys[position] == value;
+
+            if(node->isLeaf()) {
+                if(isHere) {
+                    std::move(node->keys + position + 1, node->keys + node->count, node->keys + position);
+                    --node->count;
+                }
+                return isHere;
+            }
+
+            if(isHere) {
+                NodeType* left = node->children[position];
+                NodeType* right = node->children[position + 1];
+
+                if(left->count >= MinimumDegree) {
+                    // Replace the value with its predecessor and erase that instead
+                    const NodeType* largest = left;
+                    while( ! largest->isLeaf() )
+                        largest = largest->children[largest->count];
+
+                    node->keys[position] = largest->keys[largest->count - 1];
+                    return eraseFrom(left, node->keys[position]);
+                }
+                else if(right->count >= MinimumDegree) {
+                    // Replace the value with its successor and erase that instead
+                    const NodeType* smallest = right;
+                    while( ! smallest->isLeaf() )
+                        smallest = smallest->children[0];
+
+                    node->keys[position] = smallest->keys[0];
+                    return eraseFrom(right, node->keys[position]);
+                }
+                else {
+                    mergeChildren(node, position);
+                    node = left;
+                }
+            }
+            else {
+                node = fillChild(node, position);
+            }
+        }
+    }
+
+    ///
+    /// Makes sure the child at `position` holds at least MinimumDegree values
+    ///
+    /// Borrows a value from a sibling, or merges the child with a sibling,
+    /// if both siblings are minimal.
+    /// @return The child, which now holds the values of the original one
+    ///
+    NodeType* fillChild(NodeType* parent, size_t position)
+    {
+        NodeType* child = parent->children[position];
+
+        if(child->count >= MinimumDegree)
+            return child;
+
+        NodeType* leftSibling = (position > 0) ? parent->children[position - 1] : nullptr;
+        NodeType* rightSibling = (position < parent->count) ? parent->children[position + 1] : nullptr;
+
+        if(leftSibling && leftSibling->count >= MinimumDegree) {
+            // Rotate right through the parent
+            std::move_backward(child->keys, child->keys + child->count, child->keys + child->count + 1);
+            std::copy_backward(child->children, child->children + child->count + 1, child->children + child->count + 2);
+            child->keys[0] = std::move(parent->keys[position - 1]);
+            child->children[0] = leftSibling->children[leftSibling->count];
+            ++child->count;
+
+            parent->keys[position - 1] = std::move(leftSibling->keys[leftSibling->count - 1]);
+            leftSibling->children[leftSibling->count] = nullptr;
+            --leftSibling->count;
+        }
+        else if(rightSibling && rightSibling->count >= MinimumDegree) {
+            // Rotate left through the parent
+            child->keys[child->count] = std::move(parent->keys[position]);
+            child->children[child->count + 1] = rightSibling->children[0];
+            ++child->count;
+
+            parent->keys[position] = std::move(rightSibling->keys[0]);
+            std::move(rightSibling->keys + 1, rightSibling->keys + rightSibling->count, rightSibling->keys);
+            std::copy(rightSibling->children + 1, rightSibling->children + rightSibling->count + 1, rightSibling->children);
+            rightSibling->children[rightSibling->count] = nullptr;
+            --rightSibling->count;
+        }
+        else if(rightSibling) {
+            mergeChildren(parent, position);
+        }
+        else {
+            mergeChildren(parent, position - 1);
+            child = leftSibling;
+        }
+
+        return child;
+    }
+
+    /// Merges the children at `position` and `position + 1` together with the value between them
+    void mergeChildren(NodeType* parent, size_t position)
+    {
+        NodeType* left = parent->children[position];
+        NodeType* right = parent->children[position + 1];
+
+        left->keys[left->count] = std::move(parent->keys[position]);
+        std::move(right->keys, right->keys + right->count, left->keys + left->count + 1);
+        std::copy(right->children, right->children + right->count + 1, left->children + left->count + 1);
+        left->count += right->count + 1;
+
+        std::move(parent->keys + position + 1, parent->keys + parent->count, parent->keys + position);
+        std::copy(parent->children + position + 2, parent->children + parent->count + 1, parent->children + position + 1);
+        parent->children[parent->count] = nullptr;
+        --parent->count;
+
+        m_allocator.release(right);
+    }
+
+    /// Releases all nodes in the subtree of `node`. The recursion is as deep as the tree.
+    void release(NodeType* node)
+    {
+        if( ! node )
+            return;
+
+        for(size_t i = 0; i <= node->count; ++i)
+            release(node->children[i]);
+
+        m_allocator.release(node);
+    }
+
+    /// @exception std::bad_alloc if memory allocation fails. No memory is leaked.
+    NodeType* clone(const NodeType* node)
+    {
+        if( ! node )
+            return nullptr;
+
+        NodeType* result = m_allocator.buy(*node);
+        std::fill(result->children, result->children + NodeType::MaximalKeys + 1, nullptr);
+
+        try {
+            for(size_t i = 0; ! node->isLeaf() && i <= node->count; ++i)
+                result->children[i] = clone(node->children[i]);
+        }
+        catch(std::bad_alloc&) {
+            release(result);
+            throw;
+        }
+
+        return result;
+    }
+};
@@ -0,0 +1,336 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+//
+// Tree nodes, which refer to each other with 32-bit indices instead of pointers.
+//
+// All IndexNode<T> objects live in slabs, which are registered in a table shared
+// by the whole program (see IndexNodeSlabs). An index selects a slab by its upper bits and a node
+// within the slab by its lower bits, so a handle can be dereferenced without
+// knowing the allocator which created it. An IndexNode<int> takes 12 bytes
+// instead of the 24 bytes of a Node<int>.
+//
+// To build a tree from such nodes, combine IndexNodeAllocator with a node operations
+// policy for IndexNode, e.g.:
+//
+//     BinarySearchTree<int, IndexNodeAllocator<int>, IterativeNodeOperations<int, IndexNode<int>>>
+//
+
+template <typename T>
+class IndexNode;
+
+///
+/// The slabs of all IndexNode<T> objects in the program
+///
+/// The table of slabs starts small and doubles whenever more slabs are needed, up to
+/// MaximalSlabCount entries (8 MB on 64-bit systems), which limits the program to about
+/// 2^32 nodes of each type. Other threads may be reading the table while it grows, so
+/// replaced tables are kept until the end of the program. Together they take at most
+/// as much memory as the current one.
+///
+template <typename T>
+class IndexNodeSlabs {
+public:
+    /// Number of bits of an index, which select a node within a slab
+    static constexpr unsigned SlabBits = 12;
+
+    /// Number of nodes in each slab
+    static constexpr std::uint32_t SlabSize = std::uint32_t(1) << SlabBits;
+
+    /// Maximal number of slabs. The last one is never used, so that its last index can mean null.
+    static constexpr std::uint32_t MaximalSlabCount = (std::uint32_t(1) << (32 - SlabBits)) - 1;
+
+private:
+    /// Number of entries of the table, when the first slab is acquired
+    static constexpr std::uint32_t InitialTableSize = 16;
+
+    static inline std::atomic<void**> table{nullptr};
+    static inline std::uint32_t tableSize = 0;
+    static inline std::vector<std::unique_ptr<void*[]>> tables; // The current table and all replaced ones
+    static inline std::uint32_t usedSlabs = 0;
+    static inline std::vector<std::uint32_t> freeSlabs;
+    static inline std::mutex mutex;
+
+public:
+    /// Address of the storage for the node with a given index
+    static void* address(std::uint32_t index) noexcept
+    {
+        return static_cast<IndexNode<T>*>(table.load(std::memory_order_acquire)[index >> SlabBits]) + (index & (SlabSize - 1));
+    }
+
+    /// Allocates storage for a slab and returns its number
+    /// @exception std::bad_alloc if memory allocation fails or all slabs are in use
+    static std::uint32_t acquire()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if(freeSlabs.empty() && usedSlabs == MaximalSlabCount)
+            throw std::bad_alloc();
+
+        const std::uint32_t slab = freeSlabs.empty() ? usedSlabs : freeSlabs.back();
+        if(slab == tableSize)
+            grow();
+
+        void* memory = ::operator new(SlabSize * sizeof(IndexNode<T>), std::align_val_t(alignof(IndexNode<T>)));
+
+        if(freeSlabs.empty())
+            ++usedSlabs;
+        else
+            freeSlabs.pop_back();
+
+        table.load(std::memory_order_relaxed)[slab] = memory;
+        return slab;
+    }
+
+    /// Frees the storage of a slab, so that its number can be reused
+    static void release(std::uint32_t slab)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        freeSlabs.push_back(slab);
+
+        void** current = table.load(std::memory_order_relaxed);
+        ::operator delete(current[slab], std::align_val_t(alignof(IndexNode<T>)));
+        current[slab] = nullptr;
+    }
+
+private:
+    /// Replaces the table with one of twice the size. Must be called with `mutex` locked.
+    static void grow()
+    {
+        const std::uint32_t newSize = (tableSize == 0) ? InitialTableSize
+            : (tableSize > MaximalSlabCount / 2) ? MaximalSlabCount : 2 * tableSize;
+
+        tables.reserve(tables.size() + 1);
+        std::unique_ptr<void*[]> grown(new void*[newSize]());
+
+        if(tableSize > 0)
+            std::copy_n(table.load(std::memory_order_relaxed), tableSize, grown.get());
+
+        table.store(grown.get(), std::memory_order_release);
+        tables.push_back(std::move(grown));
+        tableSize = newSize;
+    }
+};
+
+///
+/// Refers to an IndexNode<T> by its index
+///
+/// Behaves like a pointer: it can be null, compared and dereferenced.
+///
+template <typename T>
+class IndexNodeHandle {
+    std::uint32_t m_index = NullIndex;
+
+public:
+    static constexpr std::uint32_t NullIndex = 0xFFFFFFFF;
+
+    IndexNodeHandle() = default;
+
+    IndexNodeHandle(std::nullptr_t) noexcept
+    {
+    }
+
+    explicit IndexNodeHandle(std::uint32_t index) noexcept
+        : m_index(index)
+    {
+    }
+
+    std::uint32_t index() const noexcept
+    {
+        return m_index;
+    }
+
+    IndexNode<T>* operator->() const noexcept
+    {
+        return static_cast<IndexNode<T>*>(IndexNodeSlabs<T>::address(m_index));
+    }
+
+    IndexNode<T>& operator*() const noexcept
+    {
+        return *operator->();
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return m_index != NullIndex;
+    }
+
+    bool operator==(const IndexNodeHandle& other) const noexcept
+    {
+        return m_index == other.m_index;
+    }
+
+    bool operator!=(const IndexNodeHandle& other) const noexcept
+    {
+        return m_index != other.m_index;
+    }
+
+    bool operator==(std::nullptr_t) const noexcept
+    {
+        return m_index == NullIndex;
+    }
+
+    bool operator!=(std::nullptr_t) const noexcept
+    {
+        return m_index != NullIndex;
+    }
+};
+
+///
+/// A tree node, which refers to its successors by 32-bit indices
+///
+template <typename T>
+class IndexNode {
+public:
+    /// How other nodes refer to a node
+    using Handle = IndexNodeHandle<T>;
+    using ConstHandle = IndexNodeHandle<T>;
+
+    T data = T();
+    Handle left;
+    Handle right;
+
+    IndexNode()
+    {
+    }
+
+    IndexNode(const T& data)
+        : data(data)
+    {
+    }
+
+    IndexNode(T&& data)
+        : data(std::move(data))
+    {
+    }
+
+    /// @copydoc Node::Node(std::in_place_t, Args&&...)
+    template <typename... Args>
+    explicit IndexNode(std::in_place_t, Args&&... args)
+        : data(std::forward<Args>(args)...)
+    {
+    }
+
+    bool isLeaf() const noexcept
+    {
+        return ! left && ! right;
+    }
+
+    bool hasLeftSuccessor() const noexcept
+    {
+        return static_cast<bool>(left);
+    }
+
+    bool hasRightSuccessor() const noexcept
+    {
+        return static_cast<bool>(right);
+    }
+
+    /// @copydoc Node::whichSuccessorWouldStore
+    Handle& whichSuccessorWouldStore(const T& value)
+    {
+        return (value < data) ? left : right;
+    }
+
+    /// Set both successor handles to null, effectively making this node a leaf
+    void detachSuccessors()
+    {
+        left = nullptr;
+        right = nullptr;
+    }
+};
+
+///
+/// Allocates IndexNode<T> objects from slabs and recycles released nodes through a free list
+///
+/// The free list is linked by the indices of the released nodes, which are stored
+/// in their own memory. The slabs are freed when the allocator is destroyed.
+/// Nodes, which are still allocated at that point, are not destructed.
+///
+template <typename T>
+class IndexNodeAllocator {
+    using Slabs = IndexNodeSlabs<T>;
+
+    std::vector<std::uint32_t> slabs;
+    std::uint32_t freeList = IndexNodeHandle<T>::NullIndex;
+    size_t allocations = 0;
+
+public:
+    using Handle = IndexNodeHandle<T>;
+
+    IndexNodeAllocator() = default;
+
+    IndexNodeAllocator(const IndexNodeAllocator&) = delete;
+    IndexNodeAllocator& operator=(const IndexNodeAllocator&) = delete;
+
+    ~IndexNodeAllocator()
+    {
+        for(std::uint32_t slab : slabs)
+            Slabs::release(slab);
+    }
+
+    template <typename... Args>
+    Handle buy(Args&&... args)
+    {
+        if(freeList == Handle::NullIndex)
+            addSlab();
+
+        const std::uint32_t index = freeList;
+        void* memory = Slabs::address(index);
+        freeList = *static_cast<std::uint32_t*>(memory);
+
+        try {
+            new (memory) IndexNode<T>(std::forward<Args>(args)...);
+        }
+        catch(...) {
+            new (memory) std::uint32_t(freeList);
+            freeList = index;
+            throw;
+        }
+
+        ++allocations;
+        return Handle(index);
+    }
+
+    void release(Handle node)
+    {
+        if( ! node ) // do nothing when node is null
+            return;
+
+        IndexNode<T>* ptr = node.operator->();
+        ptr->~IndexNode<T>();
+        new (ptr) std::uint32_t(freeList);
+        freeList = node.index();
+        --allocations;
+    }
+
+    /// Number of nodes, which are currently allocated
+    size_t allocationsCount() const noexcept
+    {
+        return allocations;
+    }
+
+private:
+    void addSlab()
+    {
+        slabs.reserve(slabs.size() + 1);
+        const std::uint32_t slab = Slabs::acquire();
+        slabs.push_back(slab);
+
+        const std::uint32_t first = slab << Slabs::SlabBits;
+        for(std::uint32_t i = Slabs::SlabSize; i > 0; --i) {
+            new (Slabs::address(first + i - 1)) std::uint32_t(freeList);
+            freeList = first + i - 1;
+        }
+    }
+};
@@ -1,8 +1,14 @@
 #pragma once
 
+#include <utility>
+
 template <typename T>
 class Node {
 public:
+    /// How other nodes refer to a node
+    using Handle = Node*;
+    using ConstHandle = const Node*;
+
     T data = T();
     Node* left = nullptr;
     Node* right = nullptr;
@@ -16,6 +22,18 @@ public:
     {        
     }
 
+    Node(T&& data)
+        : data(std::move(data))
+    {
+    }
+
+    /// Constructs the data of the node in place from `args`
+    template <typename... Args>
+    explicit Node(std::in_place_t, Args&&... args)
+        : data(std::forward<Args>(args)...)
+    {
+    }
+
     Node(const T& data, Node* left, Node* right)
         : data(data), left(left), right(right)
     {
@@ -2,54 +2,146 @@
 
 #include "Node.h"
 
+#include <algorithm>
 #include <cassert>
-#include <stack>
+#include <cstddef>
 #include <vector>
 
-template <typename T>
+///
+/// Visits the nodes of a tree in in-order sequence
+///
+/// The iterator keeps the path of nodes, to which it has to return, in an array inside
+/// the iterator itself. Only trees deeper than `InlineDepth` continue the path on the heap,
+/// so iterating does not allocate memory for balanced trees: the default of 48 levels holds
+/// the path in any AVL tree with up to 2^32 nodes.
+///
+template <typename T, typename NodeT = Node<T>, size_t InlineDepth = 48>
 class NodeIterator {
 public:
-    using NodeType = Node<T>;
+    using NodeType = NodeT;
+    using Handle = typename NodeType::Handle;
 
 private:
-    std::stack<NodeType*> backtrack;
+    Handle inlinePath[InlineDepth > 0 ? InlineDepth : 1];
+    std::vector<Handle> overflow; // Continuation of the path below InlineDepth
+    size_t depth = 0;
 
 private:
-    void pushAllTheWayToTheLeft(NodeType* startFrom)
+    void push(Handle node)
+    {
+        if(depth < InlineDepth)
+            inlinePath[depth] = node;
+        else
+            overflow.push_back(node);
+
+        ++depth;
+    }
+
+    Handle top() const
+    {
+        return (depth <= InlineDepth) ? inlinePath[depth - 1] : overflow.back();
+    }
+
+    void pop()
+    {
+        --depth;
+
+        if(depth >= InlineDepth)
+            overflow.pop_back();
+    }
+
+    void pushAllTheWayToTheLeft(Handle startFrom)
     {
         for(; startFrom; startFrom = startFrom->left)
-            backtrack.push(startFrom);
+            push(startFrom);
     }
 
 
 public:
-    NodeIterator(NodeType* startFrom)
+    NodeIterator(Handle startFrom)
     {
         pushAllTheWayToTheLeft(startFrom);
     }
+
+    /// Copies only the used part of the path
+    NodeIterator(const NodeIterator& other)
+        : overflow(other.overflow), depth(other.depth)
+    {
+        std::copy(other.inlinePath, other.inlinePath + std::min(depth, InlineDepth), inlinePath);
+    }
+
+    NodeIterator& operator=(const NodeIterator& other)
+    {
+        overflow = other.overflow;
+        depth = other.depth;
+        std::copy(other.inlinePath, other.inlinePath + std::min(depth, InlineDepth), inlinePath);
+        return *this;
+    }
+
+    ///
+    /// Creates an iterator, which starts at the first node with a value not smaller than `value`
+    ///
+    /// A single descent from the root fills the path with the nodes,
+    /// which are visited later: those where the descent turns left. Takes time proportional
+    /// to the depth of the tree, without visiting the nodes with smaller values.
+    ///
+    static NodeIterator lowerBound(Handle startFrom, const T& value)
+    {
+        NodeIterator result(nullptr);
+
+        while(startFrom) {
+            if(startFrom->data < value) {
+                startFrom = startFrom->right;
+            }
+            else {
+                result.push(startFrom);
+                startFrom = startFrom->left;
+            }
+        }
+
+        return result;
+    }
+
+    /// Creates an iterator, which starts at the first node with a value larger than `value`
+    static NodeIterator upperBound(Handle startFrom, const T& value)
+    {
+        NodeIterator result(nullptr);
+
+        while(startFrom) {
+            if(value < startFrom->data) {
+                result.push(startFrom);
+                startFrom = startFrom->left;
+            }
+            else {
+                startFrom = startFrom->right;
+            }
+        }
+
+        return result;
+    }
     
     bool atEnd() const
     {
-        return backtrack.empty();
+        return depth == 0;
     }
 
     NodeType& operator*()
     {
         assert( ! atEnd() );
-        return *backtrack.top();
+        return *top();
     }
 
-    NodeType* operator->()
+    Handle operator->()
     {
         assert( ! atEnd() );
-        return backtrack.top();
+        return top();
     }
     
     void operator++()
     {
         assert( ! atEnd() );
-        NodeType* p = backtrack.top();
-        backtrack.pop();
+        Handle p = top();
+        pop();
         pushAllTheWayToTheLeft(p->right);
     }
 
@@ -58,7 +150,7 @@ public:
         if(atEnd() || other.atEnd())
             return atEnd() == other.atEnd();
 
-        return backtrack.top() == other.backtrack.top();
+        return top() == other.top();
     }
 
     bool operator!=(const NodeIterator& other) const
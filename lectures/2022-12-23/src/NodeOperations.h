@@ -1,7 +1,10 @@
 #pragma once
 
 #include <cassert>
+#include <exception>
 #include <stack>
+#include <utility>
+#include <vector>
 
 #include "Allocator.h"
 #include "Node.h"
@@ -10,15 +13,21 @@
 ///
 /// Recursive implementation of basic BST operations
 ///
-template <typename T>
+/// The operations work with any node type, which provides `data`, `left` and `right` members
+/// and the same member functions as Node. Nodes are referred to by `NodeType::Handle`,
+/// which is a plain pointer for Node and a 32-bit index for IndexNode.
+///
+template <typename T, typename NodeT = Node<T>>
 class RecursiveNodeOperations {
 public:
-    using NodeType = Node<T>;
+    using NodeType = NodeT;
+    using Handle = typename NodeType::Handle;
+    using ConstHandle = typename NodeType::ConstHandle;
 
     ///
     /// Checks whether two trees have the same structure and node values
     ///
-    static bool sameTrees(const Node<T>* a, const Node<T>* b)
+    static bool sameTrees(ConstHandle a, ConstHandle b)
     {
         if(a == nullptr || b == nullptr)
             return a == b;
@@ -40,7 +49,7 @@ public:
     /// If `value` is not present in the tree, the function returns a reference
     /// to that position in the tree, where it should be inserted.
     /// 
-    static Node<T>*& findPointerTo(const T& value, Node<T>*& startFrom)
+    static Handle& findPointerTo(const T& value, Handle& startFrom)
     {
         if(startFrom == nullptr || startFrom->data == value)
             return startFrom;
@@ -53,9 +62,15 @@ public:
     ///
     /// `node` itself will be inserted and no copy will be created.
     ///
-    static void insert(Node<T>*& rootptr, Node<T>& node)
+    static void insert(Handle& rootptr, Handle node)
     {
-        findPointerTo(node.data, rootptr) = &node;
+        findPointerTo(node->data, rootptr) = node;
+    }
+
+    /// Same as above, for node types whose handles are plain pointers
+    static void insert(Handle& rootptr, NodeType& node)
+    {
+        insert(rootptr, Handle(&node));
     }
 
     ///
@@ -73,7 +88,7 @@ public:
     ///   greater than that in N and thus N could not have been the
     ///   largest one in the tree.
     ///
-    static Node<T>*& findPointerToLargest(Node<T>*& startFrom)
+    static Handle& findPointerToLargest(Handle& startFrom)
     {
         return
             (startFrom == nullptr || startFrom->right == nullptr) ?
@@ -89,10 +104,10 @@ public:
     /// The extracted node will have both its successor pointers
     /// set to null.
     ///
-    static Node<T>* extract(Node<T>*& rootptr, const T& data)
+    static Handle extract(Handle& rootptr, const T& data)
     {
-        Node<T>* result = nullptr;
-        Node<T>*& parentPtr = findPointerTo(data, rootptr);
+        Handle result = nullptr;
+        Handle& parentPtr = findPointerTo(data, rootptr);
 
         if(parentPtr == nullptr) {
             // No such node is present in the tree. Nothing to do.
@@ -101,8 +116,8 @@ public:
             // The extracted nodes has a left successor and maybe
             // a right one too.
             result = parentPtr;
-            Node<T>*& ptrToPromoted = findPointerToLargest(parentPtr->left);
-            Node<T>* promoted = ptrToPromoted;
+            Handle& ptrToPromoted = findPointerToLargest(parentPtr->left);
+            Handle promoted = ptrToPromoted;
 
             // Cannot be null, because (1) parentPtr is not a leaf node
             // and also (2) has at least one successor on the left
@@ -133,7 +148,7 @@ public:
     /// @param allocator Allocator which will be used to release the occupied memory
     ///
     template <typename AllocatorType>
-    static void release(NodeType* startFrom, AllocatorType& allocator)
+    static void release(Handle startFrom, AllocatorType& allocator)
     {
         if(startFrom) {
             release(startFrom->left, allocator);
@@ -151,16 +166,15 @@ public:
     /// @exception std::bad_alloc if memory allocation fails
     ///
     template <typename AllocatorType>
-    static NodeType* clone(NodeType* startFrom, AllocatorType& allocator)
+    static Handle clone(Handle startFrom, AllocatorType& allocator)
     {
-        NodeType* result = nullptr;
+        Handle result = nullptr;
 
         if(startFrom) {
-            result = allocator.buy();
-            result->data = startFrom->data;
+            result = allocator.buy(startFrom->data);
 
-            NodeType* leftTree  = nullptr;
-            NodeType* rightTree = nullptr;
+            Handle leftTree  = nullptr;
+            Handle rightTree = nullptr;
 
             try {
                 leftTree  = clone(startFrom->left, allocator);
@@ -169,6 +183,7 @@ public:
             catch(std::bad_alloc&) {
                 release(leftTree, allocator);
                 release(rightTree, allocator);
+                allocator.release(result);
                 throw;
             }
 
@@ -178,20 +193,180 @@ public:
 
         return result;
     }    
+
+    ///
+    /// Turns a tree into a sorted list of its nodes
+    ///
+    /// The nodes are linked through their `right` pointers in in-order sequence
+    /// and their `left` pointers are set to null. Takes linear time.
+    /// @return The first node of the list
+    ///
+    static Handle toSortedList(Handle startFrom)
+    {
+        Handle list = nullptr;
+        Handle* tail = &list;
+        appendToList(startFrom, tail);
+        *tail = nullptr;
+        return list;
+    }
+
+    ///
+    /// Turns a sorted list of nodes into a perfectly balanced tree
+    ///
+    /// The list is linked through the `right` pointers of the nodes and their `left`
+    /// pointers must be null. The sizes of the two subtrees of every node differ by at most one.
+    /// Takes linear time and does not allocate memory.
+    /// @param list The first node of the list
+    /// @param size Number of nodes in the list
+    /// @return A pointer to the root of the tree
+    ///
+    static Handle fromSortedList(Handle list, size_t size)
+    {
+        return fromSortedListPrefix(list, size);
+    }
+
+    ///
+    /// Splits a tree into the nodes with values smaller and larger than `value`
+    ///
+    /// The tree is taken apart along the path to `value`, so this takes time
+    /// proportional to the depth of the tree. No nodes are allocated or released.
+    /// @param smaller Receives the root of the tree with the smaller values
+    /// @param larger Receives the root of the tree with the larger values
+    /// @return The node with `value`, detached from both trees, or nullptr if there is none
+    ///
+    static Handle split(Handle startFrom, const T& value, Handle& smaller, Handle& larger)
+    {
+        if( ! startFrom ) {
+            smaller = nullptr;
+            larger = nullptr;
+            return nullptr;
+        }
+
+        if(startFrom->data == value) {
+            smaller = startFrom->left;
+            larger = startFrom->right;
+            startFrom->detachSuccessors();
+            return startFrom;
+        }
+
+        if(value < startFrom->data) {
+            larger = startFrom;
+            return split(startFrom->left, value, smaller, startFrom->left);
+        }
+        else {
+            smaller = startFrom;
+            return split(startFrom->right, value, startFrom->right, larger);
+        }
+    }
+
+    ///
+    /// Joins two trees and a node, whose value lies between theirs, into one tree
+    ///
+    /// All values in `smaller` must be smaller than the one in `middle`
+    /// and all values in `larger` must be larger. `middle` becomes the root.
+    ///
+    static Handle join(Handle smaller, Handle middle, Handle larger)
+    {
+        middle->left = smaller;
+        middle->right = larger;
+        return middle;
+    }
+
+    ///
+    /// Joins two trees, where all values in `smaller` are smaller than those in `larger`
+    ///
+    /// `larger` is attached under the largest node of `smaller`.
+    ///
+    static Handle join(Handle smaller, Handle larger)
+    {
+        if( ! smaller )
+            return larger;
+
+        findPointerToLargest(smaller)->right = larger;
+        return smaller;
+    }
+
+    ///
+    /// Moves the nodes of a tree into a contiguous block, in in-order sequence
+    ///
+    /// The tree keeps its shape, but the node with the k-th smallest value
+    /// is moved to block[k]. The old nodes are released with `allocator`.
+    /// @param startFrom Pointer to the root element of the tree
+    /// @param block Array of already allocated nodes, one for each node of the tree
+    /// @param allocator Allocator which will be used to release the old nodes
+    /// @return A pointer to the new root of the tree
+    ///
+    template <typename AllocatorType>
+    static Handle relocate(Handle startFrom, Handle block, AllocatorType& allocator)
+    {
+        Handle next = block;
+        return relocateSubtree(startFrom, next, allocator);
+    }
+
+private:
+    /// Appends the nodes of a subtree to the list, whose last `right` pointer is `tail`
+    static void appendToList(Handle node, Handle*& tail)
+    {
+        if( ! node )
+            return;
+
+        Handle right = node->right;
+        appendToList(node->left, tail);
+
+        node->left = nullptr;
+        *tail = node;
+        tail = &node->right;
+
+        appendToList(right, tail);
+    }
+
+    /// Builds a tree from the first `size` nodes of `list` and advances `list` past them
+    static Handle fromSortedListPrefix(Handle& list, size_t size)
+    {
+        if(size == 0)
+            return nullptr;
+
+        Handle left = fromSortedListPrefix(list, size / 2);
+        Handle root = list;
+        list = list->right;
+        root->left = left;
+        root->right = fromSortedListPrefix(list, size - size / 2 - 1);
+        return root;
+    }
+
+    template <typename AllocatorType>
+    static Handle relocateSubtree(Handle node, Handle& next, AllocatorType& allocator)
+    {
+        if( ! node )
+            return nullptr;
+
+        Handle left = relocateSubtree(node->left, next, allocator);
+
+        Handle target = next++;
+        Handle right = node->right;
+        *target = std::move(*node); // Also moves any metadata, which the node type keeps
+        target->left = left;
+        allocator.release(node);
+
+        target->right = relocateSubtree(right, next, allocator);
+        return target;
+    }
 };
 
 ///
 /// Iterative implementation of basic BST operations
 ///
-template <typename T>
+template <typename T, typename NodeT = Node<T>>
 class IterativeNodeOperations {
 public:
-    using NodeType = Node<T>;
+    using NodeType = NodeT;
+    using Handle = typename NodeType::Handle;
+    using ConstHandle = typename NodeType::ConstHandle;
 
     /// @copydoc RecursiveNodeOperations::sameTrees
-    static bool sameTrees(const Node<T>* a, const Node<T>* b)
+    static bool sameTrees(ConstHandle a, ConstHandle b)
     {
-        std::stack<const Node<T>*> st;
+        std::stack<ConstHandle> st;
         st.push(a);
         st.push(b);
 
@@ -199,9 +374,9 @@ public:
         {
             assert(st.size() %2 == 0);
 
-            const Node<T>* nodeFromB = st.top();
+            ConstHandle nodeFromB = st.top();
             st.pop();
-            const Node<T>* nodeFromA = st.top();
+            ConstHandle nodeFromA = st.top();
             st.pop();
 
             if(nodeFromA == nullptr && nodeFromB == nullptr) {
@@ -224,9 +399,9 @@ public:
     }
 
     /// @copydoc RecursiveNodeOperations::findPointerTo
-    static Node<T>*& findPointerTo(const T& value, Node<T>*& startFrom)
+    static Handle& findPointerTo(const T& value, Handle& startFrom)
     {
-        Node<T>** result = &startFrom;
+        Handle* result = &startFrom;
 
         while(*result != nullptr && (*result)->data != value)
             result = &(*result)->whichSuccessorWouldStore(value);
@@ -235,15 +410,21 @@ public:
     }
 
     /// @copydoc RecursiveNodeOperations::insert
-    static void insert(Node<T>*& rootptr, Node<T>& node)
+    static void insert(Handle& rootptr, Handle node)
     {
-        findPointerTo(node.data, rootptr) = &node;
+        findPointerTo(node->data, rootptr) = node;
+    }
+
+    /// @copydoc RecursiveNodeOperations::insert
+    static void insert(Handle& rootptr, NodeType& node)
+    {
+        insert(rootptr, Handle(&node));
     }
 
     /// @copydoc RecursiveNodeOperations::findPointerToLargest
-    static Node<T>*& findPointerToLargest(Node<T>*& startFrom)
+    static Handle& findPointerToLargest(Handle& startFrom)
     {
-        Node<T>** result = &startFrom;
+        Handle* result = &startFrom;
 
         while(*result != nullptr && (*result)->right != nullptr)
             result = &(*result)->right;
@@ -252,10 +433,10 @@ public:
     }
 
     /// @copydoc RecursiveNodeOperations::extract
-    static Node<T>* extract(Node<T>*& rootptr, const T& data)
+    static Handle extract(Handle& rootptr, const T& data)
     {
-        Node<T>* result = nullptr;
-        Node<T>*& parentPtr = findPointerTo(data, rootptr);
+        Handle result = nullptr;
+        Handle& parentPtr = findPointerTo(data, rootptr);
 
         if(parentPtr == nullptr) {
             // No such node is present in the tree. Nothing to do.
@@ -264,8 +445,8 @@ public:
             // The extracted nodes has a left successor and maybe
             // a right one too.
             result = parentPtr;
-            Node<T>*& ptrToPromoted = findPointerToLargest(parentPtr->left);
-            Node<T>* promoted = ptrToPromoted;
+            Handle& ptrToPromoted = findPointerToLargest(parentPtr->left);
+            Handle promoted = ptrToPromoted;
 
             // Cannot be null, because (1) parentPtr is not a leaf node
             // and also (2) has at least one successor on the left
@@ -289,34 +470,288 @@ public:
         return result;
     }
 
+    ///
     /// @copydoc RecursiveNodeOperations::release
+    ///
+    /// Needs no extra memory: while the current node has a left successor,
+    /// a right rotation moves it up. This turns the tree into a list along
+    /// the `right` pointers, which is released node by node.
+    ///
     template <typename AllocatorType>
-    static void release(NodeType* startFrom, AllocatorType& allocator)
+    static void release(Handle startFrom, AllocatorType& allocator)
     {
-        std::stack<NodeType*> st;
-        
-        if(startFrom)
-            st.push(startFrom);
+        while(startFrom) {
+            if(Handle left = startFrom->left) {
+                startFrom->left = left->right;
+                left->right = startFrom;
+                startFrom = left;
+            }
+            else {
+                Handle right = startFrom->right;
+                allocator.release(startFrom);
+                startFrom = right;
+            }
+        }
+    }
 
-        while(! st.empty() ) {
-            NodeType* ptr = st.top();
-            st.pop();
+    ///
+    /// @copydoc RecursiveNodeOperations::clone
+    ///
+    /// Needs neither recursion nor an explicit stack. The source tree and the copy
+    /// are walked in lockstep with pointer reversal: while a subtree of a node is
+    /// being copied, the successor pointer leading to that subtree points back to
+    /// the parent of the node, both in the source tree and in the copy. The pointers
+    /// are restored on the way back up. A copied node has a right successor only once
+    /// the walk is in its right subtree, which tells the two cases apart. The root of
+    /// the copy has no parent to point to, so a flag is kept for it instead.
+    ///
+    /// If an exception is thrown, the walk goes back up without copying more nodes,
+    /// so the source tree is restored and the partial copy is released.
+    ///
+    template <typename AllocatorType>
+    static Handle clone(Handle startFrom, AllocatorType& allocator)
+    {
+        if( ! startFrom )
+            return nullptr;
+
+        Handle result = allocator.buy(startFrom->data);
+
+        Handle source = startFrom;
+        Handle copy = result;
+        Handle sourceParent = nullptr;
+        Handle copyParent = nullptr;
+        bool inRightSubtreeOfRoot = false;
+        bool leftCopied = false; // The left subtree of `source` has been copied
+        bool copied = false;     // The whole subtree of `source` has been copied
+        std::exception_ptr failure;
+
+        while(true) {
+            if( ! copied && ! failure ) {
+                try {
+                    if( ! leftCopied && source->left ) {
+                        Handle child = allocator.buy(source->left->data);
+                        Handle next = std::exchange(source->left, sourceParent);
+                        copy->left = copyParent;
+                        sourceParent = std::exchange(source, next);
+                        copyParent = std::exchange(copy, child);
+                        continue;
+                    }
+
+                    if(source->right) {
+                        Handle child = allocator.buy(source->right->data);
+                        Handle next = std::exchange(source->right, sourceParent);
+                        copy->right = copyParent;
+                        inRightSubtreeOfRoot |= (copy == result);
+                        sourceParent = std::exchange(source, next);
+                        copyParent = std::exchange(copy, child);
+                        leftCopied = false;
+                        continue;
+                    }
+                }
+                catch(...) {
+                    failure = std::current_exception();
+                }
+            }
+
+            // The subtree of `source` is done. Go back up to its parent.
+            if( ! sourceParent )
+                break;
 
-            if(ptr->left)
-                st.push(ptr->left);
-            if(ptr->right)
-                st.push(ptr->right);
+            const bool comesFromLeft = (copyParent == result) ? ! inRightSubtreeOfRoot : ! copyParent->right;
+            Handle grandparent;
+            Handle copyGrandparent;
 
-            allocator.release(ptr);
+            if(comesFromLeft) {
+                grandparent = std::exchange(sourceParent->left, source);
+                copyGrandparent = std::exchange(copyParent->left, copy);
+            }
+            else {
+                grandparent = std::exchange(sourceParent->right, source);
+                copyGrandparent = std::exchange(copyParent->right, copy);
+            }
+
+            source = std::exchange(sourceParent, grandparent);
+            copy = std::exchange(copyParent, copyGrandparent);
+            leftCopied = true;
+            copied = ! comesFromLeft;
+        }
+
+        if(failure) {
+            release(result, allocator);
+            std::rethrow_exception(failure);
         }
+
+        return result;
     }
 
-    /// @copydoc RecursiveNodeOperations::clone
+    ///
+    /// @copydoc RecursiveNodeOperations::toSortedList
+    ///
+    /// Needs no extra memory: right rotations move the left successors up,
+    /// until no node on the path along the `right` pointers has one.
+    ///
+    static Handle toSortedList(Handle startFrom)
+    {
+        Handle* link = &startFrom;
+
+        while(Handle node = *link) {
+            if(Handle left = node->left) {
+                node->left = left->right;
+                left->right = node;
+                *link = left;
+            }
+            else {
+                link = &node->right;
+            }
+        }
+
+        return startFrom;
+    }
+
+    ///
+    /// @copydoc RecursiveNodeOperations::fromSortedList
+    ///
+    /// Uses the Day-Stout-Warren algorithm: repeated passes of left rotations
+    /// along the list fold it in half until it becomes a tree. The first pass only
+    /// creates the nodes on the lowest level, so that all other levels end up full.
+    ///
+    static Handle fromSortedList(Handle list, size_t size)
+    {
+        size_t full = 1;
+        while(full * 2 <= size + 1)
+            full *= 2;
+
+        compress(list, size + 1 - full);
+
+        for(size = full - 1; size > 1; size /= 2)
+            compress(list, size / 2);
+
+        return list;
+    }
+
+    ///
+    /// @copydoc RecursiveNodeOperations::split
+    ///
+    /// Walks down the path to `value` once and hooks the visited nodes
+    /// into the smaller or the larger tree on the way.
+    ///
+    static Handle split(Handle startFrom, const T& value, Handle& smaller, Handle& larger)
+    {
+        Handle* smallerHook = &smaller; // Right successor of the largest node in the smaller tree
+        Handle* largerHook = &larger;   // Left successor of the smallest node in the larger tree
+        Handle node = startFrom;
+
+        while(node && node->data != value) {
+            if(value < node->data) {
+                *largerHook = node;
+                largerHook = &node->left;
+                node = node->left;
+            }
+            else {
+                *smallerHook = node;
+                smallerHook = &node->right;
+                node = node->right;
+            }
+        }
+
+        if( ! node ) {
+            *smallerHook = nullptr;
+            *largerHook = nullptr;
+            return nullptr;
+        }
+
+        *smallerHook = node->left;
+        *largerHook = node->right;
+        node->detachSuccessors();
+        return node;
+    }
+
+    /// @copydoc RecursiveNodeOperations::join(Handle, Handle, Handle)
+    static Handle join(Handle smaller, Handle middle, Handle larger)
+    {
+        middle->left = smaller;
+        middle->right = larger;
+        return middle;
+    }
+
+    /// @copydoc RecursiveNodeOperations::join(Handle, Handle)
+    static Handle join(Handle smaller, Handle larger)
+    {
+        if( ! smaller )
+            return larger;
+
+        findPointerToLargest(smaller)->right = larger;
+        return smaller;
+    }
+
+    /// @copydoc RecursiveNodeOperations::relocate
     template <typename AllocatorType>
-    static NodeType* clone(NodeType* startFrom, AllocatorType& allocator)
+    static Handle relocate(Handle startFrom, Handle block, AllocatorType& allocator)
     {
-        //TODO implement iterative cloning
-        throw std::exception();
+        if( ! startFrom )
+            return nullptr;
+
+        // A walk, which only reads the tree, grows the stack to the largest depth needed.
+        // If that fails, the tree is unchanged. The walk below does not allocate any more.
+        std::vector<Handle> st;
+
+        for(Handle node = startFrom; node || ! st.empty(); ) {
+            for(; node; node = node->left)
+                st.push_back(node);
+
+            node = st.back()->right;
+            st.pop_back();
+        }
+
+        // First pass: an in-order traversal moves the values to the block, together with
+        // the old successor pointers. Once the left subtree of an old node has been visited,
+        // its `left` member is no longer needed and is reused to store the node's new address.
+        Handle next = block;
+
+        for(Handle node = startFrom; node || ! st.empty(); ) {
+            for(; node; node = node->left)
+                st.push_back(node);
+
+            node = st.back();
+            st.pop_back();
+
+            Handle target = next++;
+            *target = std::move(*node);
+            node->left = target;
+
+            node = target->right;
+        }
+
+        // Second pass: translate the old successor pointers and release the old nodes.
+        // Every old node except the root is the successor of exactly one other node.
+        for(Handle target = block; target != next; ++target) {
+            for(Handle* successor : { &target->left, &target->right }) {
+                if(Handle old = *successor) {
+                    *successor = old->left;
+                    allocator.release(old);
+                }
+            }
+        }
+
+        Handle root = startFrom->left;
+        allocator.release(startFrom);
+        return root;
+    }
+
+private:
+    /// Rotates every second node of a list to the left, `count` times from its start
+    static void compress(Handle& list, size_t count)
+    {
+        Handle* link = &list;
+
+        for(size_t i = 0; i < count; ++i) {
+            Handle child = *link;
+            Handle promoted = child->right;
+            child->right = promoted->left;
+            promoted->left = child;
+            *link = promoted;
+            link = &promoted->right;
+        }
     }
 };
 
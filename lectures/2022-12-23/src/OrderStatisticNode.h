@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+
+///
+/// An AVL tree node, which also stores the number of nodes in its subtree
+///
+/// Used by OrderStatisticNodeOperations to find the k-th smallest value and the rank
+/// of a value in logarithmic time. The size makes an OrderStatisticNode<int> 8 bytes
+/// larger than an AvlNode<int>, so trees which do not need it should use AvlNode.
+///
+template <typename T>
+class OrderStatisticNode {
+public:
+    /// How other nodes refer to a node
+    using Handle = OrderStatisticNode*;
+    using ConstHandle = const OrderStatisticNode*;
+
+    T data = T();
+
+    /// Height of the subtree rooted at this node. A leaf has height 1.
+    int height = 1;
+
+    /// Number of nodes in the subtree rooted at this node, including the node itself
+    size_t size = 1;
+
+    OrderStatisticNode* left = nullptr;
+    OrderStatisticNode* right = nullptr;
+
+    OrderStatisticNode()
+    {
+    }
+
+    OrderStatisticNode(const T& data)
+        : data(data)
+    {
+    }
+
+    OrderStatisticNode(T&& data)
+        : data(std::move(data))
+    {
+    }
+
+    /// @copydoc Node::Node(std::in_place_t, Args&&...)
+    template <typename... Args>
+    explicit OrderStatisticNode(std::in_place_t, Args&&... args)
+        : data(std::forward<Args>(args)...)
+    {
+    }
+
+    bool isLeaf() const noexcept
+    {
+        return left == nullptr && right == nullptr;
+    }
+
+    bool hasLeftSuccessor() const noexcept
+    {
+        return left != nullptr;
+    }
+
+    bool hasRightSuccessor() const noexcept
+    {
+        return right != nullptr;
+    }
+
+    /// @copydoc Node::whichSuccessorWouldStore
+    OrderStatisticNode*& whichSuccessorWouldStore(const T& value)
+    {
+        return (value < data) ? left : right;
+    }
+
+    /// Set both successor pointers to null, effectively making this node a leaf
+    void detachSuccessors()
+    {
+        left = nullptr;
+        right = nullptr;
+        height = 1;
+        size = 1;
+    }
+
+    /// Recomputes the height and the size from those of the successors
+    void update() noexcept
+    {
+        height = 1 + std::max(left ? left->height : 0, right ? right->height : 0);
+        size = 1 + (left ? left->size : 0) + (right ? right->size : 0);
+    }
+};
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "AvlNodeOperations.h"
+#include "OrderStatisticNode.h"
+
+///
+/// AVL tree operations, which also find values by their position in sorted order
+///
+/// Every node stores the size of its subtree, which the AVL operations keep up to date
+/// on every change, so select(), rank() and countInRange() take O(log n) time.
+/// To use the policy, the allocator must provide OrderStatisticNode objects, e.g.:
+///
+///     BinarySearchTree<int, PoolAllocator<OrderStatisticNode<int>>, OrderStatisticNodeOperations<int>>
+///
+template <typename T>
+class OrderStatisticNodeOperations : public AvlNodeOperations<T, OrderStatisticNode<T>> {
+public:
+    using NodeType = OrderStatisticNode<T>;
+    using Handle = typename NodeType::Handle;
+    using ConstHandle = typename NodeType::ConstHandle;
+
+    /// Number of nodes in a subtree. An empty subtree has size 0.
+    static size_t size(ConstHandle node) noexcept
+    {
+        return node ? node->size : 0;
+    }
+
+    ///
+    /// Finds the node with the k-th smallest value
+    ///
+    /// @param k Zero-based position of the value in sorted order
+    /// @return The node, or nullptr if the tree has k or fewer nodes
+    ///
+    static ConstHandle select(ConstHandle node, size_t k) noexcept
+    {
+        while(node) {
+            const size_t smaller = size(node->left);
+
+            if(k == smaller)
+                return node;
+
+            if(k < smaller) {
+                node = node->left;
+            }
+            else {
+                k -= smaller + 1;
+                node = node->right;
+            }
+        }
+
+        return nullptr;
+    }
+
+    /// Number of values in a tree, which are smaller than `value`
+    static size_t rank(ConstHandle node, const T& value)
+    {
+        size_t result = 0;
+
+        while(node) {
+            if(node->data < value) {
+                result += size(node->left) + 1;
+                node = node->right;
+            }
+            else {
+                node = node->left;
+            }
+        }
+
+        return result;
+    }
+
+    /// Number of values in a tree, which are not larger than `value`
+    static size_t rankAfter(ConstHandle node, const T& value)
+    {
+        size_t result = 0;
+
+        while(node) {
+            if(value < node->data) {
+                node = node->left;
+            }
+            else {
+                result += size(node->left) + 1;
+                node = node->right;
+            }
+        }
+
+        return result;
+    }
+
+    /// Number of values `v` in a tree, for which lo <= v <= hi
+    static size_t countInRange(ConstHandle node, const T& lo, const T& hi)
+    {
+        if(hi < lo)
+            return 0;
+
+        return rankAfter(node, hi) - rank(node, lo);
+    }
+
+    /// Checks whether a tree satisfies the AVL invariants and every node stores the size of its subtree
+    static bool isValid(ConstHandle node)
+    {
+        return OrderStatisticNodeOperations::isBalanced(node) && hasValidSizes(node);
+    }
+
+private:
+    static bool hasValidSizes(ConstHandle node)
+    {
+        if( ! node )
+            return true;
+
+        return node->size == 1 + size(node->left) + size(node->right) &&
+               hasValidSizes(node->left) &&
+               hasValidSizes(node->right);
+    }
+};
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+#include "Allocator.h"
+#include "NodeIterator.h"
+#include "WorkStealingPool.h"
+
+///
+/// Parallel versions of the operations, which visit every node of a tree
+///
+/// The operations fork on the two successors of each node in the upper levels of the tree
+/// and leave the subtrees below to the sequential operations of `NodeOperations`.
+/// The sizes of subtrees are not known, so the cutoff is a depth: it is chosen to create
+/// about 16 tasks per thread of the pool in a balanced tree, enough for work stealing
+/// to even out subtrees of different sizes. With a single thread nothing is forked.
+///
+/// Allocation happens on several threads at once, so clone() and release() require
+/// an allocator, which is thread-safe (see IsThreadSafe).
+///
+template <typename NodeOperations>
+class ParallelNodeOperations {
+public:
+    using NodeType = typename NodeOperations::NodeType;
+    using Handle = typename NodeOperations::Handle;
+    using ConstHandle = typename NodeOperations::ConstHandle;
+    using ValueType = std::remove_cv_t<decltype(std::declval<NodeType&>().data)>;
+
+    /// Number of levels of a tree, whose nodes fork tasks on `pool`
+    static int forkDepth(const WorkStealingPool& pool) noexcept
+    {
+        if(pool.threadCount() <= 1)
+            return 0;
+
+        int depth = 4; // 16 tasks per thread
+        for(unsigned threads = 1; threads < pool.threadCount(); threads *= 2)
+            ++depth;
+
+        return depth;
+    }
+
+    ///
+    /// Creates a copy of a tree on the threads of `pool`
+    ///
+    /// The nodes are copied as a whole, so any extra data, like the heights
+    /// of AVL nodes, is copied too.
+    /// @exception std::bad_alloc if memory allocation fails. No memory is leaked.
+    ///
+    template <typename AllocatorType>
+    static Handle clone(WorkStealingPool& pool, Handle startFrom, AllocatorType& allocator)
+    {
+        static_assert(IsThreadSafe<AllocatorType>::value, "clone() needs a thread-safe allocator");
+
+        Handle result = nullptr;
+        pool.run([&] { result = cloneSubtree(pool, startFrom, allocator, forkDepth(pool)); });
+        return result;
+    }
+
+    /// Releases all nodes of a tree on the threads of `pool`
+    template <typename AllocatorType>
+    static void release(WorkStealingPool& pool, Handle startFrom, AllocatorType& allocator)
+    {
+        static_assert(IsThreadSafe<AllocatorType>::value, "release() needs a thread-safe allocator");
+
+        pool.run([&] { releaseSubtree(pool, startFrom, allocator, forkDepth(pool)); });
+    }
+
+    /// Checks whether two trees have the same structure and node values, on the threads of `pool`
+    static bool sameTrees(WorkStealingPool& pool, Handle a, Handle b)
+    {
+        bool result = false;
+        pool.run([&] { result = sameSubtrees(pool, a, b, forkDepth(pool)); });
+        return result;
+    }
+
+    ///
+    /// Combines the values of all nodes in a tree on the threads of `pool`
+    ///
+    /// Computes combine(... combine(combine(identity, visit(v1)), visit(v2)) ..., visit(vn))
+    /// for the values v1..vn of the tree in in-order sequence, but groups the calls differently,
+    /// so `combine` must be associative and `identity` must be its neutral element.
+    /// `visit` and `combine` are called on several threads at the same time.
+    ///
+    template <typename Result, typename Visit, typename Combine>
+    static Result reduce(WorkStealingPool& pool, Handle startFrom, Result identity, Visit visit, Combine combine)
+    {
+        Result result = identity;
+        pool.run([&] { result = reduceSubtree(pool, startFrom, identity, visit, combine, forkDepth(pool)); });
+        return result;
+    }
+
+private:
+    template <typename AllocatorType>
+    static Handle cloneSubtree(WorkStealingPool& pool, Handle node, AllocatorType& allocator, int depth)
+    {
+        if( ! node )
+            return nullptr;
+
+        if(depth <= 0)
+            return NodeOperations::clone(node, allocator);
+
+        Handle result = allocator.buy(*node);
+        Handle left = nullptr;
+        Handle right = nullptr;
+
+        try {
+            pool.forkJoin(
+                [&] { left = cloneSubtree(pool, node->left, allocator, depth - 1); },
+                [&] { right = cloneSubtree(pool, node->right, allocator, depth - 1); });
+        }
+        catch(...) {
+            NodeOperations::release(left, allocator);
+            NodeOperations::release(right, allocator);
+            allocator.release(result);
+            throw;
+        }
+
+        result->left = left;
+        result->right = right;
+        return result;
+    }
+
+    template <typename AllocatorType>
+    static void releaseSubtree(WorkStealingPool& pool, Handle node, AllocatorType& allocator, int depth)
+    {
+        if( ! node )
+            return;
+
+        if(depth <= 0) {
+            NodeOperations::release(node, allocator);
+            return;
+        }
+
+        Handle left = node->left;
+        Handle right = node->right;
+        allocator.release(node);
+
+        pool.forkJoin(
+            [&] { releaseSubtree(pool, left, allocator, depth - 1); },
+            [&] { releaseSubtree(pool, right, allocator, depth - 1); });
+    }
+
+    static bool sameSubtrees(WorkStealingPool& pool, Handle a, Handle b, int depth)
+    {
+        if(a == nullptr || b == nullptr)
+            return a == b;
+
+        if(depth <= 0)
+            return NodeOperations::sameTrees(a, b);
+
+        if(a->data != b->data)
+            return false;
+
+        bool left = false;
+        bool right = false;
+
+        pool.forkJoin(
+            [&] { left = sameSubtrees(pool, a->left, b->left, depth - 1); },
+            [&] { right = sameSubtrees(pool, a->right, b->right, depth - 1); });
+
+        return left && right;
+    }
+
+    template <typename Result, typename Visit, typename Combine>
+    static Result reduceSubtree(WorkStealingPool& pool, Handle node, const Result& identity, Visit& visit, Combine& combine, int depth)
+    {
+        if(depth <= 0) {
+            Result result = identity;
+            for(NodeIterator<ValueType, NodeType> it(node); ! it.atEnd(); ++it)
+                result = combine(std::move(result), visit(it->data));
+            return result;
+        }
+
+        if( ! node )
+            return identity;
+
+        Result left = identity;
+        Result right = identity;
+
+        pool.forkJoin(
+            [&] { left = reduceSubtree(pool, node->left, identity, visit, combine, depth - 1); },
+            [&] { right = reduceSubtree(pool, node->right, identity, visit, combine, depth - 1); });
+
+        return combine(combine(std::move(left), visit(node->data)), std::move(right));
+    }
+};
@@ -0,0 +1,185 @@
+#pragma once
+
+#include "Node.h"
+#include "NodeOperations.h"
+
+///
+/// BST operations, which move each accessed node to the root of the tree (splay tree)
+///
+/// findPointerTo(), insert() and extract() restructure the tree with top-down splaying,
+/// so recently accessed values are found after a few steps. Any sequence of m operations
+/// on a tree with n nodes takes O((m + n) log n) time, but a single operation can take O(n).
+///
+/// Since lookups change the shape of the tree, two trees with the same values compare
+/// equal with sameTrees() only if they were also accessed in the same way.
+/// Values equal to the one in a node may be stored in either of its subtrees.
+///
+/// The operations, which do not change the shape of the tree, are shared with
+/// IterativeNodeOperations, as splay trees can become deep enough to overflow the stack.
+///
+template <typename T, typename NodeT = Node<T>>
+class SplayNodeOperations : public IterativeNodeOperations<T, NodeT> {
+public:
+    using NodeType = NodeT;
+    using Handle = typename NodeType::Handle;
+    using ConstHandle = typename NodeType::ConstHandle;
+
+    ///
+    /// Finds a value in a tree and moves its node to the root
+    ///
+    /// If the value is not in the tree, the node visited last is moved to the root instead.
+    /// @return A reference to the pointer to the node with `value`, or to the position,
+    ///     at which `value` should be inserted, if it is not in the tree.
+    ///
+    static Handle& findPointerTo(const T& value, Handle& startFrom)
+    {
+        splay(startFrom, value);
+
+        Handle* result = &startFrom;
+
+        while(*result != nullptr && (*result)->data != value)
+            result = &(*result)->whichSuccessorWouldStore(value);
+
+        return *result;
+    }
+
+    ///
+    /// Inserts a node in a tree and makes it the root
+    ///
+    /// `node` itself will be inserted and no copy will be created.
+    ///
+    static void insert(Handle& rootptr, Handle node)
+    {
+        splay(rootptr, node->data);
+
+        if( ! rootptr ) {
+            node->detachSuccessors();
+        }
+        else if(node->data < rootptr->data) {
+            node->left = rootptr->left;
+            node->right = rootptr;
+            rootptr->left = nullptr;
+        }
+        else {
+            node->right = rootptr->right;
+            node->left = rootptr;
+            rootptr->right = nullptr;
+        }
+
+        rootptr = node;
+    }
+
+    /// @copydoc SplayNodeOperations::insert
+    static void insert(Handle& rootptr, NodeType& node)
+    {
+        insert(rootptr, Handle(&node));
+    }
+
+    ///
+    /// Extracts a node with a given value from a tree
+    ///
+    /// The remaining nodes are joined under the largest value smaller than the extracted one.
+    /// @return The extracted node, or nullptr if no node contains `value`.
+    ///     The node is detached from the tree, but not released.
+    ///
+    static Handle extract(Handle& rootptr, const T& value)
+    {
+        splay(rootptr, value);
+
+        if( ! rootptr || rootptr->data != value )
+            return nullptr;
+
+        Handle result = rootptr;
+
+        if( ! result->left ) {
+            rootptr = result->right;
+        }
+        else {
+            // Splaying the largest value of the left subtree leaves its root without a right successor
+            rootptr = result->left;
+            splay(rootptr, [](ConstHandle) { return 1; });
+            rootptr->right = result->right;
+        }
+
+        result->detachSuccessors();
+        return result;
+    }
+
+private:
+    static void splay(Handle& rootptr, const T& value)
+    {
+        splay(rootptr, [&value](ConstHandle node) {
+            if(node->data == value)
+                return 0;
+            return (value < node->data) ? -1 : 1;
+        });
+    }
+
+    ///
+    /// Top-down splaying
+    ///
+    /// Walks down the tree in the direction returned by `direction` for each node
+    /// (negative for left, positive for right and zero to stop), rotating every second step.
+    /// The nodes on the walk are split in a left tree, holding the nodes smaller than
+    /// the last visited one, and a right tree, holding the larger ones. Finally they become
+    /// the successors of the last visited node, which becomes the root.
+    ///
+    template <typename Direction>
+    static void splay(Handle& rootptr, Direction direction)
+    {
+        Handle node = rootptr;
+
+        if( ! node )
+            return;
+
+        Handle leftTree = nullptr;
+        Handle rightTree = nullptr;
+        Handle* leftHook = &leftTree;   // Right successor of the largest node in the left tree
+        Handle* rightHook = &rightTree; // Left successor of the smallest node in the right tree
+
+        for(int where = direction(node); where != 0; where = direction(node)) {
+            if(where < 0) {
+                if( ! node->left )
+                    break;
+
+                if(direction(node->left) < 0) { // Zig-zig: rotate right
+                    Handle promoted = node->left;
+                    node->left = promoted->right;
+                    promoted->right = node;
+                    node = promoted;
+
+                    if( ! node->left )
+                        break;
+                }
+
+                *rightHook = node;
+                rightHook = &node->left;
+                node = node->left;
+            }
+            else {
+                if( ! node->right )
+                    break;
+
+                if(direction(node->right) > 0) { // Zig-zig: rotate left
+                    Handle promoted = node->right;
+                    node->right = promoted->left;
+                    promoted->left = node;
+                    node = promoted;
+
+                    if( ! node->right )
+                        break;
+                }
+
+                *leftHook = node;
+                leftHook = &node->right;
+                node = node->right;
+            }
+        }
+
+        *leftHook = node->left;
+        *rightHook = node->right;
+        node->left = leftTree;
+        node->right = rightTree;
+        rootptr = node;
+    }
+};
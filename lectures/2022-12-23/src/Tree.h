@@ -1,8 +1,20 @@
 #pragma once
 
+#include <algorithm>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
 #include "Allocator.h"
+#include "AvlNodeOperations.h"
+#include "IndexNode.h"
 #include "NodeIterator.h"
 #include "NodeOperations.h"
+#include "OrderStatisticNodeOperations.h"
+#include "ParallelNodeOperations.h"
+#include "SplayNodeOperations.h"
 
 template <typename T>
 using SimpleNodeAllocator = SimpleAllocator<Node<T>>;
@@ -10,6 +22,21 @@ using SimpleNodeAllocator = SimpleAllocator<Node<T>>;
 template <typename T>
 using DebugNodeAllocator = DebugAllocator<Node<T>>;
 
+template <typename T>
+using PoolNodeAllocator = PoolAllocator<Node<T>>;
+
+template <typename T>
+using TrackingNodeAllocator = TrackingAllocator<Node<T>>;
+
+template <typename T>
+using ArenaNodeAllocator = ArenaAllocator<Node<T>>;
+
+template <typename T>
+using ThreadCachingNodeAllocator = ThreadCachingAllocator<Node<T>>;
+
+template <typename T>
+using LockFreeNodeAllocator = LockFreeAllocator<Node<T>>;
+
 template <
     typename ElementType,
     typename AllocatorType = SimpleNodeAllocator<ElementType>,
@@ -17,43 +44,57 @@ template <
     >
 class BinarySearchTree {
 
-    using NodeType = Node<ElementType>;
+    using NodeType = typename NodeOperations::NodeType;
+    using Handle = typename NodeOperations::Handle;
+    using ConstHandle = typename NodeOperations::ConstHandle;
 
-    NodeType* m_rootptr = nullptr;
+    Handle m_rootptr = nullptr;
     size_t m_size = 0;
     AllocatorType m_allocator;
 
 public:
     class Iterator {
-        NodeIterator<ElementType> it;
+        NodeIterator<ElementType, NodeType> it;
 
     public:
-        Iterator(NodeType* startFrom)
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = ElementType;
+        using difference_type = std::ptrdiff_t;
+        using pointer = ElementType*;
+        using reference = ElementType&;
+
+        Iterator(Handle startFrom)
             : it(startFrom)
         {            
         }
 
-        int& operator*()
+        Iterator(const NodeIterator<ElementType, NodeType>& it)
+            : it(it)
+        {
+        }
+
+        ElementType& operator*()
         {
             return it->data;
         }
 
-        int* operator->()
+        ElementType* operator->()
         {
             return &it->data;
         }
 
-        void operator++()
+        Iterator& operator++()
         {
             ++it;
+            return *this;
         }
 
-        bool operator==(const Iterator& other)
+        bool operator==(const Iterator& other) const
         {
             return it == other.it;
         }
 
-        bool operator!=(const Iterator& other)
+        bool operator!=(const Iterator& other) const
         {
             return it != other.it;
         }
@@ -73,6 +114,18 @@ public:
         m_size = other.m_size;
     }
 
+    ///
+    /// Creates a copy of `other`, cloning its subtrees on the threads of `pool`
+    ///
+    /// The allocator must be thread-safe, e.g. ThreadCachingAllocator or LockFreeAllocator.
+    /// @exception std::bad_alloc if memory allocation fails
+    ///
+    BinarySearchTree(const BinarySearchTree& other, WorkStealingPool& pool)
+    {
+        m_rootptr = ParallelNodeOperations<NodeOperations>::clone(pool, other.m_rootptr, m_allocator);
+        m_size = other.m_size;
+    }
+
     BinarySearchTree& operator=(const BinarySearchTree& other)
     {
         if(this != &other) {
@@ -83,9 +136,28 @@ public:
         return *this;
     }
 
+    ///
+    /// Removes all elements from the tree
+    ///
+    /// If the allocator releases its memory in bulk, the nodes are not visited at all
+    /// and the allocator is reset instead.
+    ///
     void clear()
     {
-        NodeOperations::release(m_rootptr, m_allocator);
+        if constexpr (ReleasesInBulk<AllocatorType>::value)
+            m_allocator.reset();
+        else
+            NodeOperations::release(m_rootptr, m_allocator);
+
+        m_rootptr = nullptr;
+        m_size = 0;
+    }
+
+    /// Removes all elements from the tree, releasing the nodes on the threads of `pool`.
+    /// The allocator must be thread-safe.
+    void clear(WorkStealingPool& pool)
+    {
+        ParallelNodeOperations<NodeOperations>::release(pool, m_rootptr, m_allocator);
         m_rootptr = nullptr;
         m_size = 0;
     }
@@ -112,16 +184,195 @@ public:
 
     void insert(const ElementType& value)
     {
-        NodeType* ptr = m_allocator.buy();
-        ptr->data = value;
+        NodeOperations::insert(m_rootptr, m_allocator.buy(value));
+        ++m_size;
+    }
+
+    void insert(ElementType&& value)
+    {
+        NodeOperations::insert(m_rootptr, m_allocator.buy(std::move(value)));
+        ++m_size;
+    }
 
-        NodeOperations::insert(m_rootptr, *ptr);
+    /// Inserts a value constructed in place from `args`, without creating temporary copies
+    template <typename... Args>
+    void emplace(Args&&... args)
+    {
+        NodeOperations::insert(m_rootptr, m_allocator.buy(std::in_place, std::forward<Args>(args)...));
         ++m_size;
     }
 
+    ///
+    /// Replaces the contents of the tree with the values in [first, last), which must be sorted
+    ///
+    /// Builds a perfectly balanced tree in linear time. If the allocator provides buyBlock(),
+    /// all nodes are allocated in a single block, in in-order sequence.
+    /// @exception std::bad_alloc if memory allocation fails. No memory is leaked and the tree
+    ///     remains unchanged, unless the allocator releases memory in bulk. Then the tree is
+    ///     cleared before the new nodes are allocated.
+    ///
+    template <typename ForwardIterator>
+    void assignSorted(ForwardIterator first, ForwardIterator last)
+    {
+        // Releasing in bulk would release the new nodes too, so it has to happen first
+        if constexpr (ReleasesInBulk<AllocatorType>::value)
+            clear();
+
+        const size_t count = std::distance(first, last);
+        Handle root = NodeOperations::fromSortedList(buyList(first, count), count);
+
+        if constexpr ( ! ReleasesInBulk<AllocatorType>::value )
+            clear();
+
+        m_rootptr = root;
+        m_size = count;
+    }
+
+    /// Replaces the contents of the tree with the values in [first, last), which can be in any order.
+    /// Sorts a copy of the values and passes it to assignSorted().
+    template <typename InputIterator>
+    void assign(InputIterator first, InputIterator last)
+    {
+        std::vector<ElementType> values(first, last);
+        std::sort(values.begin(), values.end());
+        assignSorted(std::make_move_iterator(values.begin()), std::make_move_iterator(values.end()));
+    }
+
+    ///
+    /// Inserts all values in [first, last)
+    ///
+    /// The batch is sorted first. If it is large compared to the tree, the tree is turned
+    /// into a sorted list, merged with the new nodes and rebuilt as a balanced tree,
+    /// which takes O(n + m) time. Otherwise the values are inserted one by one in O(m log n).
+    /// As with insert(), the values must be distinct and must not be in the tree yet.
+    /// @exception std::bad_alloc if memory allocation fails. The tree remains unchanged.
+    ///
+    template <typename InputIterator>
+    void insertBatch(InputIterator first, InputIterator last)
+    {
+        std::vector<ElementType> batch(first, last);
+        std::sort(batch.begin(), batch.end());
+
+        // Allocating all nodes first leaves nothing that could fail afterwards
+        Handle added = buyList(std::make_move_iterator(batch.begin()), batch.size());
+
+        if(isSmallBatch(batch.size())) {
+            while(added) {
+                Handle node = added;
+                added = added->right;
+                node->right = nullptr;
+                NodeOperations::insert(m_rootptr, node);
+            }
+        }
+        else {
+            Handle merged = mergeLists(NodeOperations::toSortedList(m_rootptr), added);
+            m_rootptr = NodeOperations::fromSortedList(merged, m_size + batch.size());
+        }
+
+        m_size += batch.size();
+    }
+
+    ///
+    /// Removes one occurrence of each value in [first, last) from the tree
+    ///
+    /// Like insertBatch(), either rebuilds the tree in O(n + m) or erases
+    /// the values one by one in O(m log n), whichever is expected to be faster.
+    ///
+    template <typename InputIterator>
+    void eraseBatch(InputIterator first, InputIterator last)
+    {
+        std::vector<ElementType> batch(first, last);
+        std::sort(batch.begin(), batch.end());
+
+        if(isSmallBatch(batch.size())) {
+            for(const ElementType& value : batch)
+                erase(value);
+            return;
+        }
+
+        Handle list = NodeOperations::toSortedList(m_rootptr);
+        Handle kept = nullptr;
+        Handle* tail = &kept;
+        auto value = batch.cbegin();
+
+        while(list) {
+            Handle node = list;
+            list = list->right;
+
+            while(value != batch.cend() && *value < node->data)
+                ++value;
+
+            if(value != batch.cend() && *value == node->data) {
+                ++value;
+                --m_size;
+                m_allocator.release(node);
+            }
+            else {
+                *tail = node;
+                tail = &node->right;
+            }
+        }
+
+        *tail = nullptr;
+        m_rootptr = NodeOperations::fromSortedList(kept, m_size);
+    }
+
+    ///
+    /// Adds the values of `other`, which are not in the tree yet
+    ///
+    /// `other` is copied first. Then the copy is split at the root of the tree and
+    /// the halves are merged with the two subtrees recursively, reusing all nodes.
+    /// Nodes of the copy with values already in the tree are released. With AvlNodeOperations
+    /// a tree of n and a tree of m <= n values are merged in O(m log(n/m + 1)) time.
+    /// @exception std::bad_alloc if memory allocation fails. The tree remains unchanged.
+    ///
+    void unionWith(const BinarySearchTree& other)
+    {
+        unionWith(other, nullptr);
+    }
+
+    /// Same as unionWith(other), but merges disjoint subtrees on the threads of `pool`
+    void unionWith(const BinarySearchTree& other, WorkStealingPool& pool)
+    {
+        unionWith(other, &pool);
+    }
+
+    ///
+    /// Removes the values, which are not in `other`
+    ///
+    /// The tree is split at the root of `other` and the halves are intersected with
+    /// its two subtrees recursively. `other` is not modified and no memory is allocated.
+    ///
+    void intersect(const BinarySearchTree& other)
+    {
+        intersect(other, nullptr);
+    }
+
+    /// Same as intersect(other), but works on disjoint subtrees on the threads of `pool`
+    void intersect(const BinarySearchTree& other, WorkStealingPool& pool)
+    {
+        intersect(other, &pool);
+    }
+
+    ///
+    /// Removes the values, which are in `other`
+    ///
+    /// Works like intersect(), but keeps the nodes, which are not found in `other`.
+    ///
+    void difference(const BinarySearchTree& other)
+    {
+        difference(other, nullptr);
+    }
+
+    /// Same as difference(other), but works on disjoint subtrees on the threads of `pool`
+    void difference(const BinarySearchTree& other, WorkStealingPool& pool)
+    {
+        difference(other, &pool);
+    }
+
     void erase(const ElementType& value)
     {
-        Node<ElementType>* extracted = NodeOperations::extract(m_rootptr, value);
+        Handle extracted = NodeOperations::extract(m_rootptr, value);
         
         if(extracted != nullptr) {
             --m_size;
@@ -129,11 +380,84 @@ public:
         }
     }
 
+    ///
+    /// Moves all nodes of the tree into a single contiguous block of memory
+    ///
+    /// The nodes are placed in in-order sequence, so that iterating the tree
+    /// reads memory sequentially, and the shape of the tree does not change.
+    /// The allocator must provide buyBlock(n), which allocates n adjacent nodes,
+    /// and trim(), which frees the memory left unused afterwards (e.g. PoolAllocator).
+    /// Iterators and pointers to elements are invalidated.
+    /// @exception std::bad_alloc if memory allocation fails. The tree remains unchanged.
+    ///
+    void compact()
+    {
+        if( ! m_rootptr )
+            return;
+
+        Handle block = m_allocator.buyBlock(m_size);
+        m_rootptr = NodeOperations::relocate(m_rootptr, block, m_allocator);
+
+        try {
+            m_allocator.trim();
+        }
+        catch(std::bad_alloc&) {
+            // The tree is already compacted. Only the unused memory is not returned.
+        }
+    }
+
+    ///
+    /// Returns the k-th smallest value in the tree, counting from zero
+    ///
+    /// Takes O(log n) time. Only available with a node operations policy,
+    /// which tracks the sizes of subtrees, such as OrderStatisticNodeOperations.
+    /// @exception std::out_of_range if the tree has k or fewer values
+    ///
+    const ElementType& select(size_t k) const
+    {
+        auto node = NodeOperations::select(m_rootptr, k);
+
+        if( ! node )
+            throw std::out_of_range("BinarySearchTree::select(): k is out of range");
+
+        return node->data;
+    }
+
+    /// Number of values in the tree, which are smaller than `value`. Same requirements as select().
+    size_t rank(const ElementType& value) const
+    {
+        return NodeOperations::rank(m_rootptr, value);
+    }
+
+    /// Number of values `v` in the tree, for which lo <= v <= hi. Same requirements as select().
+    size_t countInRange(const ElementType& lo, const ElementType& hi) const
+    {
+        return NodeOperations::countInRange(m_rootptr, lo, hi);
+    }
+
     bool operator==(const BinarySearchTree& other) const
     {
         return NodeOperations::sameTrees(this->m_rootptr, other.m_rootptr);
     }
 
+    /// Same as operator==, but compares the subtrees on the threads of `pool`
+    bool equals(const BinarySearchTree& other, WorkStealingPool& pool) const
+    {
+        return ParallelNodeOperations<NodeOperations>::sameTrees(pool, m_rootptr, other.m_rootptr);
+    }
+
+    ///
+    /// Combines the results of `visit` for all values of the tree with `combine`, on the threads of `pool`
+    ///
+    /// `combine` must be associative and `identity` must be its neutral element,
+    /// e.g. std::plus<>() and 0. See ParallelNodeOperations::reduce().
+    ///
+    template <typename Result, typename Visit, typename Combine>
+    Result parallelReduce(WorkStealingPool& pool, Result identity, Visit visit, Combine combine) const
+    {
+        return ParallelNodeOperations<NodeOperations>::reduce(pool, m_rootptr, identity, visit, combine);
+    }
+
     Iterator beginIterator()
     {
         return Iterator(m_rootptr);
@@ -143,4 +467,322 @@ public:
     {
         return Iterator(nullptr);
     }
+
+    /// Iterator to the first value, which is not smaller than `value`, or endIterator() if there is none
+    Iterator lowerBound(const ElementType& value)
+    {
+        return Iterator(NodeIterator<ElementType, NodeType>::lowerBound(m_rootptr, value));
+    }
+
+    /// Iterator to the first value, which is larger than `value`, or endIterator() if there is none
+    Iterator upperBound(const ElementType& value)
+    {
+        return Iterator(NodeIterator<ElementType, NodeType>::upperBound(m_rootptr, value));
+    }
+
+    /// The range of values equal to `value`, as a pair of lowerBound() and upperBound()
+    std::pair<Iterator, Iterator> equalRange(const ElementType& value)
+    {
+        return { lowerBound(value), upperBound(value) };
+    }
+
+    ///
+    /// Calls `visit` for every value `v` in the tree, for which lo <= v <= hi, in sorted order
+    ///
+    /// Only the subtrees which may contain such values are visited. Unlike a loop over
+    /// iterators, this needs no backtrack stack and `visit` can be inlined.
+    /// The recursion is as deep as the tree.
+    ///
+    template <typename Visitor>
+    void forEachInRange(const ElementType& lo, const ElementType& hi, Visitor&& visit) const
+    {
+        visitRange(m_rootptr, lo, hi, visit);
+    }
+
+private:
+    template <typename Visitor>
+    static void visitRange(ConstHandle node, const ElementType& lo, const ElementType& hi, Visitor& visit)
+    {
+        while(node) {
+            if(node->data < lo) {
+                node = node->right;
+            }
+            else if(hi < node->data) {
+                node = node->left;
+            }
+            else {
+                visitRange(node->left, lo, hi, visit);
+                visit(static_cast<const ElementType&>(node->data));
+                node = node->right;
+            }
+        }
+    }
+
+    /// Whether applying a batch of `count` values one by one is expected to be cheaper than rebuilding the tree
+    bool isSmallBatch(size_t count) const noexcept
+    {
+        size_t depth = 1;
+        for(size_t n = m_size; n > 1; n /= 2)
+            ++depth;
+
+        return count * depth < m_size;
+    }
+
+    /// Merges two sorted lists of nodes, linked through their `right` pointers.
+    /// Nodes of `a` come before equal nodes of `b`.
+    static Handle mergeLists(Handle a, Handle b)
+    {
+        Handle result = nullptr;
+        Handle* tail = &result;
+
+        while(a && b) {
+            Handle& smaller = (b->data < a->data) ? b : a;
+            *tail = smaller;
+            tail = &smaller->right;
+            smaller = smaller->right;
+        }
+
+        *tail = a ? a : b;
+        return result;
+    }
+
+    //
+    // The set operations split one tree at the root of the other one and recurse
+    // on the two halves. Nodes, which are removed on the way, are collected in a list
+    // linked through their `right` pointers and released at the end, so that
+    // the recursion does not use the allocator and can run on several threads.
+    //
+
+    void unionWith(const BinarySearchTree& other, WorkStealingPool* pool)
+    {
+        if(this == &other)
+            return;
+
+        Handle copy = NodeOperations::clone(other.m_rootptr, m_allocator);
+        Handle discarded = nullptr;
+        runSetOperation(pool, [&](int forkDepth) { m_rootptr = unite(m_rootptr, copy, discarded, pool, forkDepth); });
+        m_size += other.m_size - releaseList(discarded);
+    }
+
+    void intersect(const BinarySearchTree& other, WorkStealingPool* pool)
+    {
+        if(this == &other)
+            return;
+
+        Handle discarded = nullptr;
+        runSetOperation(pool, [&](int forkDepth) { m_rootptr = intersectSubtrees(m_rootptr, other.m_rootptr, discarded, pool, forkDepth); });
+        m_size -= releaseList(discarded);
+    }
+
+    void difference(const BinarySearchTree& other, WorkStealingPool* pool)
+    {
+        if(this == &other) {
+            clear();
+            return;
+        }
+
+        Handle discarded = nullptr;
+        runSetOperation(pool, [&](int forkDepth) { m_rootptr = subtractSubtrees(m_rootptr, other.m_rootptr, discarded, pool, forkDepth); });
+        m_size -= releaseList(discarded);
+    }
+
+    /// Runs `operation` on one of the workers of `pool` with the fork depth of
+    /// ParallelNodeOperations, or on the calling thread without forking if there is no pool
+    template <typename Operation>
+    static void runSetOperation(WorkStealingPool* pool, Operation operation)
+    {
+        if( ! pool ) {
+            operation(0);
+            return;
+        }
+
+        const int forkDepth = ParallelNodeOperations<NodeOperations>::forkDepth(*pool);
+        bool done = false;
+
+        try {
+            pool->run([&] { operation(forkDepth); done = true; });
+        }
+        catch(std::bad_alloc&) {
+            // The task could not be queued. The operation itself does not throw.
+        }
+
+        if( ! done )
+            operation(0);
+    }
+
+    ///
+    /// Runs `first` and `second` on disjoint subtrees, forking `second` on `pool` if forkDepth > 0
+    ///
+    /// The recursion does not allocate and cannot throw. Only queueing a task on the pool can fail.
+    /// It fails before either function has run, so they are then simply run one after the other.
+    ///
+    template <typename First, typename Second>
+    static void forkJoin(WorkStealingPool* pool, int forkDepth, Handle& discarded, First first, Second second)
+    {
+        Handle discardedBySecond = nullptr;
+        bool forked = false;
+
+        if(pool && forkDepth > 0) {
+            try {
+                pool->forkJoin([&] { first(discarded); }, [&] { second(discardedBySecond); });
+                forked = true;
+            }
+            catch(std::bad_alloc&) {
+            }
+        }
+
+        if( ! forked ) {
+            first(discarded);
+            second(discarded);
+            return;
+        }
+
+        prependList(discardedBySecond, discarded);
+    }
+
+    /// Puts the nodes of `list` in front of the list `discarded`
+    static void prependList(Handle list, Handle& discarded) noexcept
+    {
+        if( ! list )
+            return;
+
+        Handle last = list;
+        while(last->right)
+            last = last->right;
+
+        last->right = discarded;
+        discarded = list;
+    }
+
+    /// Releases the nodes of a list and returns their number
+    size_t releaseList(Handle list)
+    {
+        size_t count = 0;
+
+        while(list) {
+            Handle next = list->right;
+            m_allocator.release(list);
+            list = next;
+            ++count;
+        }
+
+        return count;
+    }
+
+    static Handle unite(Handle a, Handle b, Handle& discarded, WorkStealingPool* pool, int forkDepth)
+    {
+        if( ! a )
+            return b;
+        if( ! b )
+            return a;
+
+        Handle smallerOfB = b->left;
+        Handle largerOfB = b->right;
+        b->detachSuccessors();
+
+        Handle smaller = nullptr;
+        Handle larger = nullptr;
+        Handle middle = NodeOperations::split(a, b->data, smaller, larger);
+
+        if(middle)
+            prependList(b, discarded);
+        else
+            middle = b;
+
+        forkJoin(pool, forkDepth, discarded,
+            [&](Handle& list) { smaller = unite(smaller, smallerOfB, list, pool, forkDepth - 1); },
+            [&](Handle& list) { larger = unite(larger, largerOfB, list, pool, forkDepth - 1); });
+
+        return NodeOperations::join(smaller, middle, larger);
+    }
+
+    static Handle intersectSubtrees(Handle a, Handle b, Handle& discarded, WorkStealingPool* pool, int forkDepth)
+    {
+        if( ! a )
+            return nullptr;
+
+        if( ! b ) {
+            prependList(NodeOperations::toSortedList(a), discarded);
+            return nullptr;
+        }
+
+        Handle smaller = nullptr;
+        Handle larger = nullptr;
+        Handle middle = NodeOperations::split(a, b->data, smaller, larger);
+
+        forkJoin(pool, forkDepth, discarded,
+            [&](Handle& list) { smaller = intersectSubtrees(smaller, b->left, list, pool, forkDepth - 1); },
+            [&](Handle& list) { larger = intersectSubtrees(larger, b->right, list, pool, forkDepth - 1); });
+
+        if(middle)
+            return NodeOperations::join(smaller, middle, larger);
+        else
+            return NodeOperations::join(smaller, larger);
+    }
+
+    static Handle subtractSubtrees(Handle a, Handle b, Handle& discarded, WorkStealingPool* pool, int forkDepth)
+    {
+        if( ! a || ! b )
+            return a;
+
+        Handle smaller = nullptr;
+        Handle larger = nullptr;
+        Handle middle = NodeOperations::split(a, b->data, smaller, larger);
+
+        if(middle)
+            prependList(middle, discarded);
+
+        forkJoin(pool, forkDepth, discarded,
+            [&](Handle& list) { smaller = subtractSubtrees(smaller, b->left, list, pool, forkDepth - 1); },
+            [&](Handle& list) { larger = subtractSubtrees(larger, b->right, list, pool, forkDepth - 1); });
+
+        return NodeOperations::join(smaller, larger);
+    }
+
+    /// Allocates nodes for `count` values, which are linked through their `right` pointers in the same order
+    template <typename ForwardIterator>
+    Handle buyList(ForwardIterator first, size_t count)
+    {
+        if(count == 0)
+            return nullptr;
+
+        if constexpr (BuysInBlocks<AllocatorType>::value) {
+            Handle block = m_allocator.buyBlock(count);
+
+            try {
+                for(size_t i = 0; i < count; ++i, ++first) {
+                    block[i].data = *first;
+                    block[i].right = (i + 1 < count) ? &block[i + 1] : nullptr;
+                }
+            }
+            catch(...) {
+                for(size_t i = 0; i < count; ++i)
+                    m_allocator.release(&block[i]);
+                throw;
+            }
+
+            return block;
+        }
+        else {
+            Handle list = nullptr;
+            Handle* tail = &list;
+
+            try {
+                for(size_t i = 0; i < count; ++i, ++first) {
+                    *tail = m_allocator.buy(*first);
+                    tail = &(*tail)->right;
+                }
+            }
+            catch(...) {
+                while(list) {
+                    Handle next = list->right;
+                    m_allocator.release(list);
+                    list = next;
+                }
+                throw;
+            }
+
+            return list;
+        }
+    }
 };
\ No newline at end of file
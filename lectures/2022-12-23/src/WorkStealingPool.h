@@ -0,0 +1,309 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+///
+/// A fixed set of worker threads, which execute fork-join tasks with work stealing
+///
+/// Every worker has a deque of tasks. forkJoin() pushes the second of its two functions
+/// at the back of the calling worker's deque and runs the first one directly. Idle workers
+/// steal from the front of the other deques, where the oldest and therefore largest tasks are.
+/// A worker, whose task was stolen, executes other tasks until the stolen one completes,
+/// so no worker blocks while there is work to do.
+///
+/// Tasks live on the stack of the function, which forked them, so forking does not allocate
+/// memory apart from the occasional growth of a deque.
+///
+class WorkStealingPool {
+    struct Task {
+        void (*execute)(Task&);
+        std::atomic<bool> done{false};
+        bool external = false; // Submitted by run() from a thread outside the pool
+        std::exception_ptr error;
+
+        explicit Task(void (*execute)(Task&))
+            : execute(execute)
+        {
+        }
+    };
+
+    template <typename Function>
+    struct TaskFor : Task {
+        Function& function;
+
+        explicit TaskFor(Function& function)
+            : Task(&call), function(function)
+        {
+        }
+
+        static void call(Task& task)
+        {
+            static_cast<TaskFor&>(task).function();
+        }
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task*> tasks;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+
+    std::mutex mutex; // Guards `injected` and `stopping` and is used for sleeping
+    std::condition_variable wakeUp;
+    std::condition_variable finished;
+    std::deque<Task*> injected;
+    bool stopping = false;
+
+    std::atomic<size_t> queued{0};
+    std::atomic<size_t> sleeping{0};
+
+    static inline thread_local WorkStealingPool* currentPool = nullptr;
+    static inline thread_local size_t currentWorker = 0;
+
+public:
+    /// Starts `threadCount` worker threads. Zero means one for each hardware thread.
+    explicit WorkStealingPool(unsigned threadCount = 0)
+    {
+        if(threadCount == 0)
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+        for(unsigned i = 0; i < threadCount; ++i)
+            workers.push_back(std::make_unique<Worker>());
+
+        try {
+            for(unsigned i = 0; i < threadCount; ++i)
+                threads.emplace_back([this, i] { work(i); });
+        }
+        catch(...) {
+            stop();
+            throw;
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    ~WorkStealingPool()
+    {
+        stop();
+    }
+
+    unsigned threadCount() const noexcept
+    {
+        return static_cast<unsigned>(workers.size());
+    }
+
+    ///
+    /// Runs `function` on one of the workers and waits for it to complete
+    ///
+    /// `function` can call forkJoin() to split its work. If called from a worker
+    /// of this pool, `function` simply runs on the calling thread.
+    /// Exceptions thrown by `function` are passed to the caller.
+    ///
+    template <typename Function>
+    void run(Function&& function)
+    {
+        if(currentPool == this) {
+            function();
+            return;
+        }
+
+        TaskFor<Function> task(function);
+        task.external = true;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            injected.push_back(&task);
+            ++queued;
+        }
+        wakeUp.notify_one();
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            finished.wait(lock, [&task] { return task.done.load(); });
+        }
+
+        if(task.error)
+            std::rethrow_exception(task.error);
+    }
+
+    ///
+    /// Runs `first` and `second`, possibly in parallel, and waits for both to complete
+    ///
+    /// `second` can be stolen by another worker, while the calling one runs `first`.
+    /// Outside a run() of this pool, the two functions are called one after the other.
+    /// If either function throws, the exception is passed on after both have completed.
+    ///
+    template <typename First, typename Second>
+    void forkJoin(First&& first, Second&& second)
+    {
+        if(currentPool != this) {
+            first();
+            second();
+            return;
+        }
+
+        Worker& worker = *workers[currentWorker];
+        TaskFor<Second> task(second);
+        push(worker, task);
+
+        std::exception_ptr error;
+        try {
+            first();
+        }
+        catch(...) {
+            error = std::current_exception();
+        }
+
+        if(takeBack(worker, task)) {
+            execute(task);
+        }
+        else {
+            // The task was stolen. Help with other tasks meanwhile.
+            while( ! task.done.load(std::memory_order_acquire) ) {
+                if(Task* other = findTask(currentWorker))
+                    execute(*other);
+                else
+                    std::this_thread::yield();
+            }
+        }
+
+        if(error)
+            std::rethrow_exception(error);
+        if(task.error)
+            std::rethrow_exception(task.error);
+    }
+
+private:
+    void push(Worker& worker, Task& task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            worker.tasks.push_back(&task);
+        }
+
+        ++queued;
+
+        // A worker going to sleep increments `sleeping` before it checks `queued` again,
+        // so either it sees the new task, or this thread sees it sleeping
+        if(sleeping.load() > 0) {
+            { std::lock_guard<std::mutex> lock(mutex); }
+            wakeUp.notify_one();
+        }
+    }
+
+    /// Removes `task` from the back of the worker's deque, unless it was stolen
+    bool takeBack(Worker& worker, Task& task)
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+
+        if(worker.tasks.empty() || worker.tasks.back() != &task)
+            return false;
+
+        worker.tasks.pop_back();
+        --queued;
+        return true;
+    }
+
+    /// Takes a task from the back of the own deque, from the front of another one, or from the injected tasks
+    Task* findTask(size_t index)
+    {
+        for(size_t i = 0; i < workers.size(); ++i) {
+            Worker& victim = *workers[(index + i) % workers.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+
+            if( ! victim.tasks.empty() ) {
+                Task* task = nullptr;
+
+                if(i == 0) {
+                    task = victim.tasks.back();
+                    victim.tasks.pop_back();
+                }
+                else {
+                    task = victim.tasks.front();
+                    victim.tasks.pop_front();
+                }
+
+                --queued;
+                return task;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if(injected.empty())
+            return nullptr;
+
+        Task* task = injected.front();
+        injected.pop_front();
+        --queued;
+        return task;
+    }
+
+    void execute(Task& task) noexcept
+    {
+        try {
+            task.execute(task);
+        }
+        catch(...) {
+            task.error = std::current_exception();
+        }
+
+        if(task.external) {
+            // The waiting thread checks `done` under the mutex, so it cannot destroy
+            // the task before this thread has stopped using it
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                task.done.store(true);
+            }
+            finished.notify_all();
+        }
+        else {
+            task.done.store(true, std::memory_order_release);
+        }
+    }
+
+    void work(size_t index)
+    {
+        currentPool = this;
+        currentWorker = index;
+
+        while(true) {
+            if(Task* task = findTask(index)) {
+                execute(*task);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(mutex);
+            ++sleeping;
+            wakeUp.wait(lock, [this] { return stopping || queued.load() > 0; });
+            --sleeping;
+
+            if(stopping)
+                return;
+        }
+    }
+
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeUp.notify_all();
+
+        for(std::thread& thread : threads)
+            thread.join();
+    }
+};
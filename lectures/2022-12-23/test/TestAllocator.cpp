@@ -1,9 +1,24 @@
 #include "catch2/catch_all.hpp"
 #include "Allocator.h"
 
-TEST_CASE("DebugAllocator allocates and releases correctly", "[allocator]")
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+using TrackingAllocatorTypes = std::tuple<
+    DebugAllocator<int>,
+    TrackingAllocator<int>
+>;
+
+TEMPLATE_LIST_TEST_CASE("DebugAllocator allocates and releases correctly", "[allocator]", TrackingAllocatorTypes)
 {
-    DebugAllocator<int> da;
+    TestType da;
     std::vector<int*> allocations;
     const int count = 5;
 
@@ -23,21 +38,475 @@ TEST_CASE("DebugAllocator allocates and releases correctly", "[allocator]")
     }
 }
 
-TEST_CASE("DebugAllocator::release() throws when trying to release a pointer not allocated by it", "[allocator]")
+TEMPLATE_LIST_TEST_CASE("DebugAllocator::release() throws when trying to release a pointer not allocated by it", "[allocator]", TrackingAllocatorTypes)
 {
-    DebugAllocator<int> da;
+    TestType da;
     int* ptr = new int;
     CHECK_THROWS_AS(da.release(ptr), std::invalid_argument);
     delete ptr;
+
+    TestType other;
+    int* fromOther = other.buy();
+    CHECK_THROWS_AS(da.release(fromOther), std::invalid_argument);
+    other.release(fromOther);
+}
+
+TEMPLATE_LIST_TEST_CASE("DebugAllocator::release() throws when releasing a pointer twice", "[allocator]", TrackingAllocatorTypes)
+{
+    TestType da;
+    int* ptr = da.buy();
+    int* other = da.buy();
+
+    CHECK_NOTHROW(da.release(ptr));
+    CHECK_THROWS_AS(da.release(ptr), std::invalid_argument);
+    CHECK(da.allocationsCount() == 1);
+    CHECK_NOTHROW(da.release(other));
 }
 
-TEST_CASE("DebugAllocator::release() does nothing when releasing null", "[allocator]")
+TEMPLATE_LIST_TEST_CASE("DebugAllocator::release() does nothing when releasing null", "[allocator]", TrackingAllocatorTypes)
 {
-    DebugAllocator<int> da;
+    TestType da;
     int* ptr = da.buy();
 
     CHECK_NOTHROW(da.release(nullptr));
     
     CHECK(da.allocationsCount() == 1);
     CHECK_NOTHROW(da.release(ptr));
-}
\ No newline at end of file
+}
+
+TEST_CASE("TrackingAllocator::release() throws for pointers into the middle of an object", "[allocator]")
+{
+    TrackingAllocator<long long> ta;
+    long long* ptr = ta.buy();
+    int* inside = reinterpret_cast<int*>(ptr) + 1;
+
+    CHECK_THROWS_AS(ta.release(reinterpret_cast<long long*>(inside)), std::invalid_argument);
+    CHECK(ta.allocationsCount() == 1);
+    CHECK_NOTHROW(ta.release(ptr));
+}
+
+TEST_CASE("TrackingAllocator handles many slabs", "[allocator]")
+{
+    TrackingAllocator<int> ta;
+    std::vector<int*> allocations;
+    const size_t count = 3 * TrackingAllocator<int>::SlotsPerSlab;
+
+    for(size_t i = 0; i < count; ++i) {
+        allocations.push_back(ta.buy());
+        *allocations.back() = static_cast<int>(i);
+    }
+
+    for(size_t i = 0; i < count; ++i)
+        CHECK(*allocations[i] == static_cast<int>(i));
+
+    for(int* ptr : allocations)
+        ta.release(ptr);
+
+    CHECK(ta.allocationsCount() == 0);
+    CHECK(ta.totalAllocationsCount() == count);
+}
+
+TEST_CASE("PoolAllocator allocates and releases correctly", "[allocator]")
+{
+    PoolAllocator<int> pa;
+    std::vector<int*> allocations;
+    const int count = 100; // More than one slab
+
+    for(int i = 1; i <= count; ++i) {
+        int* ptr = pa.buy();
+        CHECK(*ptr == 0); // Objects are value-initialized
+        *ptr = i;
+        allocations.push_back(ptr);
+        CHECK(pa.allocationsCount() == size_t(i));
+    }
+
+    CHECK(pa.capacityCount() >= count);
+
+    for(int i = 0; i < count; ++i)
+        CHECK(*allocations[i] == i + 1); // No two objects overlap
+
+    for(int i = count-1; i >= 0; --i) {
+        CHECK_NOTHROW(pa.release(allocations[i]));
+        CHECK(pa.allocationsCount() == size_t(i));
+    }
+}
+
+TEST_CASE("PoolAllocator reuses released objects without growing", "[allocator]")
+{
+    PoolAllocator<int> pa;
+    int* first = pa.buy();
+    const size_t capacity = pa.capacityCount();
+
+    pa.release(first);
+    int* second = pa.buy();
+
+    CHECK(second == first);
+    CHECK(pa.capacityCount() == capacity);
+    pa.release(second);
+}
+
+TEST_CASE("PoolAllocator::release() does nothing when releasing null", "[allocator]")
+{
+    PoolAllocator<int> pa;
+    int* ptr = pa.buy();
+
+    CHECK_NOTHROW(pa.release(nullptr));
+
+    CHECK(pa.allocationsCount() == 1);
+    CHECK_NOTHROW(pa.release(ptr));
+}
+
+TEST_CASE("PoolAllocator returns correctly aligned objects", "[allocator]")
+{
+    struct alignas(32) Wide { char data[40]; };
+    PoolAllocator<Wide> pa;
+    std::vector<Wide*> allocations;
+
+    for(int i = 0; i < 50; ++i) {
+        allocations.push_back(pa.buy());
+        CHECK(reinterpret_cast<std::uintptr_t>(allocations.back()) % alignof(Wide) == 0);
+    }
+
+    for(Wide* ptr : allocations)
+        pa.release(ptr);
+}
+
+TEST_CASE("PoolAllocator::buyBlock() allocates adjacent objects", "[allocator]")
+{
+    PoolAllocator<long long> pa;
+    CHECK(pa.buyBlock(0) == nullptr);
+
+    long long* block = pa.buyBlock(10);
+    CHECK(pa.allocationsCount() == 10);
+
+    for(int i = 0; i < 10; ++i)
+        CHECK(block[i] == 0);
+
+    for(int i = 0; i < 10; ++i)
+        pa.release(&block[i]);
+
+    CHECK(pa.allocationsCount() == 0);
+}
+
+TEST_CASE("PoolAllocator::trim() frees only the slabs without allocated objects", "[allocator]")
+{
+    PoolAllocator<long long> pa;
+    std::vector<long long*> allocations;
+
+    for(int i = 0; i < 100; ++i)
+        allocations.push_back(pa.buy());
+
+    long long* block = pa.buyBlock(5);
+    for(long long* ptr : allocations)
+        pa.release(ptr);
+
+    pa.trim();
+    CHECK(pa.capacityCount() == 5);
+    CHECK(pa.allocationsCount() == 5);
+
+    for(int i = 0; i < 5; ++i)
+        pa.release(&block[i]);
+
+    pa.trim();
+    CHECK(pa.capacityCount() == 0);
+
+    long long* ptr = pa.buy(); // Still usable after all slabs were freed
+    pa.release(ptr);
+}
+
+TEST_CASE("ArenaAllocator allocates distinct objects", "[allocator]")
+{
+    ArenaAllocator<int> aa;
+    std::vector<int*> allocations;
+    const int count = 200; // More than one chunk
+
+    for(int i = 1; i <= count; ++i) {
+        int* ptr = aa.buy();
+        CHECK(*ptr == 0);
+        *ptr = i;
+        allocations.push_back(ptr);
+    }
+
+    CHECK(aa.totalAllocationsCount() == count);
+
+    for(int i = 0; i < count; ++i)
+        CHECK(*allocations[i] == i + 1);
+}
+
+TEST_CASE("ArenaAllocator::release() does nothing and reset() reclaims all objects", "[allocator]")
+{
+    static int liveObjects = 0;
+
+    struct Counted {
+        Counted() { ++liveObjects; }
+        ~Counted() { --liveObjects; }
+    };
+
+    {
+        ArenaAllocator<Counted> aa;
+        Counted* first = aa.buy();
+        aa.buy();
+        aa.buy();
+
+        aa.release(first);
+        CHECK(liveObjects == 3);
+        CHECK(aa.totalAllocationsCount() == 3);
+
+        aa.reset();
+        CHECK(liveObjects == 0);
+        CHECK(aa.totalAllocationsCount() == 0);
+
+        aa.buy();
+        CHECK(liveObjects == 1);
+    }
+
+    CHECK(liveObjects == 0); // The destructor resets the allocator
+}
+
+TEST_CASE("ReleasesInBulk recognizes allocators, which reclaim memory with reset()", "[allocator]")
+{
+    CHECK(ReleasesInBulk<ArenaAllocator<int>>::value);
+    CHECK_FALSE(ReleasesInBulk<SimpleAllocator<int>>::value);
+    CHECK_FALSE(ReleasesInBulk<DebugAllocator<int>>::value);
+    CHECK_FALSE(ReleasesInBulk<PoolAllocator<int>>::value);
+}
+
+TEST_CASE("ThreadCachingAllocator allocates and releases correctly", "[allocator]")
+{
+    ThreadCachingAllocator<int> ta;
+    std::vector<int*> allocations;
+    const int count = 300; // More than several batches
+
+    for(int i = 1; i <= count; ++i) {
+        int* ptr = ta.buy();
+        CHECK(*ptr == 0);
+        *ptr = i;
+        allocations.push_back(ptr);
+        CHECK(ta.allocationsCount() == size_t(i));
+    }
+
+    for(int i = 0; i < count; ++i)
+        CHECK(*allocations[i] == i + 1);
+
+    for(int i = count-1; i >= 0; --i)
+        ta.release(allocations[i]);
+
+    CHECK(ta.allocationsCount() == 0);
+    CHECK_NOTHROW(ta.release(nullptr));
+}
+
+TEST_CASE("ThreadCachingAllocator handles objects released on another thread", "[allocator]")
+{
+    ThreadCachingAllocator<long> ta;
+    const size_t count = 1000;
+    std::vector<long*> allocations(count);
+
+    std::thread producer([&] {
+        for(size_t i = 0; i < count; ++i) {
+            allocations[i] = ta.buy();
+            *allocations[i] = static_cast<long>(i);
+        }
+    });
+    producer.join(); // The producer's cache is returned to the depot on exit
+
+    std::thread consumer([&] {
+        for(size_t i = 0; i < count; ++i) {
+            CHECK(*allocations[i] == static_cast<long>(i));
+            ta.release(allocations[i]);
+        }
+
+        // The released objects are reused by the releasing thread
+        long* reused = ta.buy();
+        CHECK(std::find(allocations.begin(), allocations.end(), reused) != allocations.end());
+        ta.release(reused);
+    });
+    consumer.join();
+
+    CHECK(ta.allocationsCount() == 0);
+}
+
+TEST_CASE("ThreadCachingAllocator can be used by many threads concurrently", "[allocator]")
+{
+    ThreadCachingAllocator<size_t> ta;
+    const size_t threadCount = 4;
+    const size_t rounds = 50;
+    const size_t perRound = 200;
+    std::vector<std::thread> threads;
+    std::atomic<bool> handedOutTwice{false};
+
+    for(size_t t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&ta, &handedOutTwice, t] {
+            std::vector<size_t*> owned;
+            for(size_t round = 0; round < rounds; ++round) {
+                for(size_t i = 0; i < perRound; ++i) {
+                    owned.push_back(ta.buy());
+                    *owned.back() = t;
+                }
+                for(size_t* ptr : owned) {
+                    if(*ptr != t)
+                        handedOutTwice = true;
+                    ta.release(ptr);
+                }
+                owned.clear();
+            }
+        });
+    }
+
+    for(std::thread& thread : threads)
+        thread.join();
+
+    CHECK_FALSE(handedOutTwice);
+    CHECK(ta.allocationsCount() == 0);
+}
+
+TEST_CASE("LockFreeAllocator allocates and releases correctly", "[allocator]")
+{
+    LockFreeAllocator<int> la;
+    std::vector<int*> allocations;
+    const int count = 500; // Several slabs
+
+    for(int i = 1; i <= count; ++i) {
+        int* ptr = la.buy();
+        CHECK(*ptr == 0);
+        *ptr = i;
+        allocations.push_back(ptr);
+        CHECK(la.allocationsCount() == size_t(i));
+    }
+
+    for(int i = 0; i < count; ++i)
+        CHECK(*allocations[i] == i + 1);
+
+    for(int* ptr : allocations)
+        la.release(ptr);
+
+    CHECK(la.allocationsCount() == 0);
+    CHECK_NOTHROW(la.release(nullptr));
+
+    int* reused = la.buy();
+    CHECK(std::find(allocations.begin(), allocations.end(), reused) != allocations.end());
+    la.release(reused);
+}
+
+/// Many threads buy and release objects at random and check that no object is handed out twice
+template <typename AllocatorType>
+bool stressConcurrentBuyAndRelease(AllocatorType& allocator, size_t threadCount, size_t steps)
+{
+    std::atomic<bool> handedOutTwice{false};
+    std::vector<std::thread> threads;
+
+    for(size_t t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t] {
+            std::vector<size_t*> owned;
+            size_t state = t + 1;
+
+            for(size_t i = 0; i < steps; ++i) {
+                state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+
+                if(owned.empty() || (state >> 60) < 9) {
+                    owned.push_back(allocator.buy());
+                    *owned.back() = t;
+                }
+                else {
+                    size_t* ptr = owned.back();
+                    owned.pop_back();
+                    if(*ptr != t)
+                        handedOutTwice = true;
+                    allocator.release(ptr);
+                }
+            }
+
+            for(size_t* ptr : owned) {
+                if(*ptr != t)
+                    handedOutTwice = true;
+                allocator.release(ptr);
+            }
+        });
+    }
+
+    for(std::thread& thread : threads)
+        thread.join();
+
+    return ! handedOutTwice;
+}
+
+TEST_CASE("LockFreeAllocator hands out each object to one thread at a time", "[allocator]")
+{
+    LockFreeAllocator<size_t> la;
+    CHECK(stressConcurrentBuyAndRelease(la, 8, 50'000));
+    CHECK(la.allocationsCount() == 0);
+}
+
+/// A PoolAllocator protected by a mutex, for comparison with LockFreeAllocator
+template <typename T>
+class MutexPoolAllocator {
+    std::mutex mutex;
+    PoolAllocator<T> pool;
+
+public:
+    T* buy()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return pool.buy();
+    }
+
+    void release(T* ptr)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pool.release(ptr);
+    }
+};
+
+//
+// This test is hidden. Run it explicitly with: unit-tests "[benchmark]"
+//
+using StringAllocatorTypes = std::tuple<
+    SimpleAllocator<std::string>,
+    DebugAllocator<std::string>,
+    TrackingAllocator<std::string>,
+    PoolAllocator<std::string>,
+    ArenaAllocator<std::string>,
+    ThreadCachingAllocator<std::string>,
+    LockFreeAllocator<std::string>
+>;
+
+TEMPLATE_LIST_TEST_CASE("buy() passes its arguments to the constructor of the object", "[allocator]", StringAllocatorTypes)
+{
+    TestType allocator;
+    std::string moved(100, 'm');
+
+    std::string* empty = allocator.buy();
+    std::string* filled = allocator.buy(3, 'x');
+    std::string* copied = allocator.buy(*filled);
+    std::string* stolen = allocator.buy(std::move(moved));
+
+    CHECK(empty->empty());
+    CHECK(*filled == "xxx");
+    CHECK(*copied == "xxx");
+    CHECK(*stolen == std::string(100, 'm'));
+    CHECK(moved.empty()); // Rvalues are moved, not copied
+
+    for(std::string* ptr : {empty, filled, copied, stolen})
+        allocator.release(ptr);
+}
+
+TEST_CASE("LockFreeAllocator and a mutex-based pool under concurrent buy and release", "[.][benchmark]")
+{
+    const size_t threadCount = GENERATE(1, 2, 4, 8, 16);
+    const size_t steps = 1'000'000;
+
+    auto measure = [&](auto& allocator) {
+        auto start = std::chrono::steady_clock::now();
+        stressConcurrentBuyAndRelease(allocator, threadCount, steps);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return threadCount * steps / elapsed.count() / 1e6;
+    };
+
+    MutexPoolAllocator<size_t> mutexPool;
+    LockFreeAllocator<size_t> lockFree;
+    const double mutexThroughput = measure(mutexPool);
+    const double lockFreeThroughput = measure(lockFree);
+
+    WARN(threadCount << " threads: "
+        << "mutex pool " << mutexThroughput << " M ops/s, "
+        << "LockFreeAllocator " << lockFreeThroughput << " M ops/s");
+}
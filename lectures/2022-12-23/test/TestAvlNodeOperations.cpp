@@ -0,0 +1,314 @@
+#include "catch2/catch_all.hpp"
+#include "Tree.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <set>
+#include <vector>
+
+using AvlOperations = AvlNodeOperations<int>;
+using AvlBst = BinarySearchTree<int, PoolAllocator<AvlNode<int>>, AvlOperations>;
+
+/// Upper bound of the height of an AVL tree with `size` nodes
+static int maximalAvlHeight(size_t size)
+{
+    return static_cast<int>(1.45 * std::log2(size + 2.0));
+}
+
+/// Inserts values in the order given by `values` and returns the nodes in the same order
+static std::vector<AvlNode<int>*> insertAll(AvlNode<int>*& rootptr, PoolAllocator<AvlNode<int>>& allocator, const std::vector<int>& values)
+{
+    std::vector<AvlNode<int>*> nodes;
+
+    for(int value : values) {
+        nodes.push_back(allocator.buy(value));
+        AvlOperations::insert(rootptr, nodes.back());
+    }
+
+    return nodes;
+}
+
+/// Values 0..size-1 in increasing order
+static std::vector<int> sortedValues(int size)
+{
+    std::vector<int> values(size);
+    std::iota(values.begin(), values.end(), 0);
+    return values;
+}
+
+/// Values of a tree in in-order sequence
+static std::vector<int> inOrderValues(AvlNode<int>* rootptr)
+{
+    std::vector<int> values;
+    for(NodeIterator<int, AvlNode<int>> it(rootptr); ! it.atEnd(); ++it)
+        values.push_back(it->data);
+    return values;
+}
+
+TEST_CASE("AvlNode<int> takes as much memory as Node<int>", "[avl]")
+{
+    CHECK(sizeof(AvlNode<int>) == sizeof(Node<int>));
+}
+
+TEST_CASE("AvlNodeOperations::insert() keeps the tree balanced for sorted input", "[avl]")
+{
+    PoolAllocator<AvlNode<int>> allocator;
+    AvlNode<int>* rootptr = nullptr;
+    const int count = 1000;
+
+    for(int i = 0; i < count; ++i) {
+        AvlOperations::insert(rootptr, allocator.buy(i));
+        REQUIRE(AvlOperations::isBalanced(rootptr));
+        REQUIRE(AvlOperations::height(rootptr) <= maximalAvlHeight(i + 1));
+    }
+
+    for(int i = 0; i < count; ++i)
+        CHECK(AvlOperations::findPointerTo(i, rootptr) != nullptr);
+
+    AvlOperations::release(rootptr, allocator);
+    CHECK(allocator.allocationsCount() == 0);
+}
+
+TEST_CASE("AvlNodeOperations::extract() keeps the tree balanced", "[avl]")
+{
+    std::mt19937 generator(12345);
+    PoolAllocator<AvlNode<int>> allocator;
+    AvlNode<int>* rootptr = nullptr;
+    std::multiset<int> expected;
+    std::uniform_int_distribution<int> distribution(0, 200); // Many duplicates
+
+    for(int step = 0; step < 5000; ++step) {
+        const int value = distribution(generator);
+
+        if(step % 3 == 2) {
+            AvlNode<int>* extracted = AvlOperations::extract(rootptr, value);
+            auto it = expected.find(value);
+
+            if(it == expected.end()) {
+                REQUIRE(extracted == nullptr);
+            }
+            else {
+                REQUIRE(extracted != nullptr);
+                CHECK(extracted->data == value);
+                CHECK(extracted->isLeaf());
+                expected.erase(it);
+                allocator.release(extracted);
+            }
+        }
+        else {
+            AvlOperations::insert(rootptr, allocator.buy(value));
+            expected.insert(value);
+        }
+
+        REQUIRE(AvlOperations::isBalanced(rootptr));
+        REQUIRE(AvlOperations::height(rootptr) <= maximalAvlHeight(expected.size()));
+    }
+
+    std::vector<int> visited;
+    for(NodeIterator<int, AvlNode<int>> it(rootptr); ! it.atEnd(); ++it)
+        visited.push_back(it->data);
+
+    CHECK(visited == std::vector<int>(expected.begin(), expected.end()));
+    CHECK(allocator.allocationsCount() == expected.size());
+
+    AvlOperations::release(rootptr, allocator);
+}
+
+TEST_CASE("AvlNodeOperations::extract() returns nullptr for values not in the tree", "[avl]")
+{
+    PoolAllocator<AvlNode<int>> allocator;
+    AvlNode<int>* rootptr = nullptr;
+
+    CHECK(AvlOperations::extract(rootptr, 1) == nullptr);
+
+    insertAll(rootptr, allocator, {1, 2, 3, 4, 5});
+    CHECK(AvlOperations::extract(rootptr, 10) == nullptr);
+    CHECK(AvlOperations::isBalanced(rootptr));
+
+    AvlOperations::release(rootptr, allocator);
+}
+
+TEST_CASE("AvlNodeOperations::clone() copies the values and the heights", "[avl]")
+{
+    PoolAllocator<AvlNode<int>> allocator;
+    AvlNode<int>* rootptr = nullptr;
+    std::vector<int> values(100);
+    std::iota(values.begin(), values.end(), 0);
+    insertAll(rootptr, allocator, values);
+
+    AvlNode<int>* copy = AvlOperations::clone(rootptr, allocator);
+
+    CHECK(AvlOperations::sameTrees(rootptr, copy));
+    CHECK(AvlOperations::isBalanced(copy));
+    CHECK(allocator.allocationsCount() == 2 * values.size());
+
+    AvlOperations::release(rootptr, allocator);
+    AvlOperations::release(copy, allocator);
+}
+
+TEST_CASE("AvlNodeOperations::fromSortedList() builds a balanced tree with correct heights", "[avl]")
+{
+    for(int size = 0; size <= 200; ++size) {
+        std::vector<AvlNode<int>> nodes(size);
+        for(int i = 0; i < size; ++i) {
+            nodes[i].data = i;
+            nodes[i].right = (i + 1 < size) ? &nodes[i + 1] : nullptr;
+        }
+
+        AvlNode<int>* rootptr = AvlOperations::fromSortedList(size ? &nodes[0] : nullptr, size);
+
+        REQUIRE(AvlOperations::isBalanced(rootptr));
+        CHECK(inOrderValues(rootptr) == sortedValues(size));
+    }
+}
+
+TEST_CASE("AvlNodeOperations::split() and join() keep the trees balanced", "[avl]")
+{
+    PoolAllocator<AvlNode<int>> allocator;
+    AvlNode<int>* rootptr = nullptr;
+    const int count = 500;
+    insertAll(rootptr, allocator, sortedValues(count));
+
+    for(int value = -1; value <= count; value += 7) {
+        AvlNode<int>* smaller = nullptr;
+        AvlNode<int>* larger = nullptr;
+        AvlNode<int>* found = AvlOperations::split(rootptr, value, smaller, larger);
+
+        REQUIRE(AvlOperations::isBalanced(smaller));
+        REQUIRE(AvlOperations::isBalanced(larger));
+        CHECK(inOrderValues(smaller) == sortedValues(std::clamp(value, 0, count)));
+        CHECK(inOrderValues(larger).size() == size_t(count - std::clamp(value + 1, 0, count)));
+
+        if(found) {
+            CHECK(found->data == value);
+            rootptr = AvlOperations::join(smaller, found, larger);
+        }
+        else {
+            rootptr = AvlOperations::join(smaller, larger);
+        }
+
+        REQUIRE(AvlOperations::isBalanced(rootptr));
+        REQUIRE(inOrderValues(rootptr) == sortedValues(count));
+    }
+
+    AvlOperations::release(rootptr, allocator);
+}
+
+TEST_CASE("AvlNodeOperations::join() balances trees of very different heights", "[avl]")
+{
+    PoolAllocator<AvlNode<int>> allocator;
+    AvlNode<int>* small = nullptr;
+    AvlNode<int>* large = nullptr;
+    insertAll(small, allocator, {0, 1, 2});
+
+    std::vector<int> values(1000);
+    std::iota(values.begin(), values.end(), 4);
+    insertAll(large, allocator, values);
+
+    AvlNode<int>* middle = allocator.buy(3);
+    AvlNode<int>* rootptr = AvlOperations::join(small, middle, large);
+
+    CHECK(AvlOperations::isBalanced(rootptr));
+    CHECK(inOrderValues(rootptr) == sortedValues(1004));
+
+    AvlOperations::release(rootptr, allocator);
+}
+
+TEST_CASE("BinarySearchTree works with AvlNodeOperations", "[avl]")
+{
+    AvlBst bst;
+
+    for(int i = 0; i < 100; ++i)
+        bst.insert(i);
+
+    for(int i = 0; i < 100; i += 2)
+        bst.erase(i);
+
+    CHECK(bst.size() == 50);
+    CHECK(bst.allocator().allocationsCount() == 50);
+
+    for(int i = 0; i < 100; ++i)
+        CHECK(bst.contains(i) == (i % 2 == 1));
+
+    AvlBst copy(bst);
+    CHECK(copy == bst);
+
+    copy.compact();
+    CHECK(copy == bst); // The heights are kept as well
+
+    copy.insert(100);
+    copy.erase(100);
+    CHECK(copy.size() == bst.size()); // The shape may differ after the rotations
+    CHECK_FALSE(copy.contains(100));
+
+    int expected = 1;
+    for(auto it = copy.beginIterator(); it != copy.endIterator(); ++it, expected += 2)
+        CHECK(*it == expected);
+}
+
+/// Values 0..size-1 in random order
+static std::vector<int> randomValues(int size)
+{
+    std::vector<int> values = sortedValues(size);
+    std::shuffle(values.begin(), values.end(), std::mt19937(42));
+    return values;
+}
+
+/// Values alternating from both ends towards the middle: 0, size-1, 1, size-2, ...
+/// Produces a degenerate zig-zag path in an unbalanced tree.
+static std::vector<int> zigZagValues(int size)
+{
+    std::vector<int> values;
+    values.reserve(size);
+
+    for(int low = 0, high = size - 1; low <= high; ++low, --high) {
+        values.push_back(low);
+        if(low != high)
+            values.push_back(high);
+    }
+
+    return values;
+}
+
+/// Builds a tree from `values` and looks up each of them
+template <typename Bst>
+size_t buildAndLookup(const std::vector<int>& values)
+{
+    Bst bst;
+
+    for(int value : values)
+        bst.insert(value);
+
+    size_t found = 0;
+    for(int value : values)
+        found += bst.contains(value);
+
+    return found;
+}
+
+//
+// This test is hidden. Run it explicitly with: unit-tests "[benchmark]"
+//
+TEST_CASE("Build and lookup with unbalanced and AVL trees for different insertion orders", "[.][benchmark]")
+{
+    const int size = 10'000;
+    using UnbalancedBst = BinarySearchTree<int, PoolNodeAllocator<int>, IterativeNodeOperations<int>>;
+
+    for(auto [name, values] : {
+            std::pair{"sorted", sortedValues(size)},
+            std::pair{"random", randomValues(size)},
+            std::pair{"zig-zag", zigZagValues(size)} })
+    {
+        BENCHMARK(std::string("Unbalanced, ") + name)
+        {
+            return buildAndLookup<UnbalancedBst>(values);
+        };
+
+        BENCHMARK(std::string("AVL, ") + name)
+        {
+            return buildAndLookup<AvlBst>(values);
+        };
+    }
+}
@@ -0,0 +1,345 @@
+#include "catch2/catch_all.hpp"
+#include "BTree.h"
+#include "Tree.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+/// A B-tree with at most 3 values per node, so that small tests build deep trees
+using SmallBTree = BTree<int, 64, PoolAllocator<BTreeNode<int, 64>>>;
+
+template <typename Tree>
+std::vector<int> valuesOf(const Tree& tree)
+{
+    std::vector<int> values;
+    for(auto it = tree.beginIterator(); it != tree.endIterator(); ++it)
+        values.push_back(*it);
+    return values;
+}
+
+TEST_CASE("BTreeNode fits the requested size", "[btree]")
+{
+    CHECK(sizeof(BTreeNode<int>) <= 256);
+    CHECK(BTreeNode<int>::MaximalKeys >= 15);
+    CHECK(sizeof(BTreeNode<std::string>) <= 256);
+    CHECK(BTreeNode<int, 64>::MaximalKeys == 3);
+    CHECK(BTreeNode<int, 4096>::MaximalKeys > 300);
+}
+
+TEST_CASE("BTreeNode::lowerBound() and upperBound() find the positions of values", "[btree]")
+{
+    BTreeNode<int> node;
+    node.count = 5;
+    std::copy_n(std::begin({10, 20, 20, 20, 30}), 5, node.keys);
+
+    CHECK(node.lowerBound(5) == 0);
+    CHECK(node.lowerBound(10) == 0);
+    CHECK(node.lowerBound(20) == 1);
+    CHECK(node.lowerBound(25) == 4);
+    CHECK(node.lowerBound(35) == 5);
+
+    CHECK(node.upperBound(5) == 0);
+    CHECK(node.upperBound(10) == 1);
+    CHECK(node.upperBound(20) == 4);
+    CHECK(node.upperBound(30) == 5);
+}
+
+TEST_CASE("BTreeNode::lowerBound() and upperBound() work for nodes larger than the linear search limit", "[btree]")
+{
+    auto node = std::make_unique<BTreeNode<int, 4096>>();
+    node->count = BTreeNode<int, 4096>::MaximalKeys;
+    for(size_t i = 0; i < node->count; ++i)
+        node->keys[i] = int(i) * 2;
+
+    for(size_t i = 0; i < node->count; ++i) {
+        REQUIRE(node->lowerBound(int(i) * 2) == i);
+        REQUIRE(node->lowerBound(int(i) * 2 + 1) == i + 1);
+        REQUIRE(node->upperBound(int(i) * 2) == i + 1);
+        REQUIRE(node->upperBound(int(i) * 2 - 1) == i);
+    }
+}
+
+TEMPLATE_TEST_CASE("BTreeNode::lowerBound() and upperBound() agree with std::lower_bound() for all arithmetic types", "[btree]",
+    char, unsigned char, short, unsigned short, int, unsigned, long long, unsigned long long, float, double)
+{
+    using NodeType = BTreeNode<TestType, 512>;
+    auto node = std::make_unique<NodeType>();
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> distribution(1, 100);
+
+    for(size_t count = 0; count <= NodeType::MaximalKeys; ++count) {
+        node->count = count;
+        for(size_t i = 0; i < count; ++i)
+            node->keys[i] = TestType(distribution(generator));
+        std::sort(node->keys, node->keys + count);
+
+        const auto* keys = node->keys;
+        for(int value = 0; value <= 101; ++value) {
+            const TestType key = TestType(value);
+            REQUIRE(node->lowerBound(key) == size_t(std::lower_bound(keys, keys + count, key) - keys));
+            REQUIRE(node->upperBound(key) == size_t(std::upper_bound(keys, keys + count, key) - keys));
+        }
+    }
+}
+
+TEST_CASE("BTree::BTree() constructs an empty tree", "[btree]")
+{
+    BTree<int> tree;
+    CHECK(tree.empty());
+    CHECK(tree.size() == 0);
+    CHECK_FALSE(tree.contains(0));
+    CHECK(tree.beginIterator() == tree.endIterator());
+    CHECK(tree.isValid());
+}
+
+TEST_CASE("BTree::insert() and contains() work for sorted and random values", "[btree]")
+{
+    SmallBTree tree;
+    std::vector<int> values(1000);
+    std::iota(values.begin(), values.end(), 0);
+
+    SECTION("Sorted") {}
+    SECTION("Reversed") { std::reverse(values.begin(), values.end()); }
+    SECTION("Random") { std::shuffle(values.begin(), values.end(), std::mt19937(42)); }
+
+    for(int value : values) {
+        tree.insert(value * 2);
+        REQUIRE(tree.isValid());
+    }
+
+    CHECK(tree.size() == values.size());
+
+    for(int i = 0; i < 2000; ++i)
+        CHECK(tree.contains(i) == (i % 2 == 0));
+
+    std::sort(values.begin(), values.end());
+    std::transform(values.begin(), values.end(), values.begin(), [](int v) { return v * 2; });
+    CHECK(valuesOf(tree) == values);
+}
+
+TEST_CASE("BTree::insert() moves rvalues and emplace() constructs values from arguments", "[btree]")
+{
+    // unique_ptr cannot be copied, so this only compiles if values are never copied
+    BTree<std::unique_ptr<int>, 128, PoolAllocator<BTreeNode<std::unique_ptr<int>, 128>>> tree;
+
+    for(int i = 0; i < 100; ++i) {
+        auto value = std::make_unique<int>(i);
+        tree.insert(std::move(value));
+        CHECK_FALSE(value);
+    }
+
+    for(int i = 100; i < 200; ++i)
+        tree.emplace(new int(i));
+
+    CHECK(tree.size() == 200);
+    CHECK(tree.isValid());
+
+    int sum = 0;
+    for(auto it = tree.beginIterator(); it != tree.endIterator(); ++it)
+        sum += **it;
+    CHECK(sum == 199 * 200 / 2);
+
+    BTree<std::string> strings;
+    strings.emplace(3, 'b');
+    strings.emplace("a");
+    CHECK(strings.contains("bbb"));
+    CHECK(strings.contains("a"));
+}
+
+/// Key, whose copy can be made to fail
+struct ThrowingCopyKey {
+    static inline bool throwOnCopy = false;
+    int value = 0;
+
+    ThrowingCopyKey() = default;
+    ThrowingCopyKey(int value) : value(value) {}
+    ThrowingCopyKey(ThrowingCopyKey&&) noexcept = default;
+    ThrowingCopyKey& operator=(ThrowingCopyKey&&) noexcept = default;
+
+    ThrowingCopyKey(const ThrowingCopyKey& other) : value(other.value)
+    {
+        if(throwOnCopy)
+            throw std::bad_alloc();
+    }
+
+    ThrowingCopyKey& operator=(const ThrowingCopyKey& other)
+    {
+        if(throwOnCopy)
+            throw std::bad_alloc();
+        value = other.value;
+        return *this;
+    }
+
+    bool operator<(const ThrowingCopyKey& other) const { return value < other.value; }
+    bool operator==(const ThrowingCopyKey& other) const { return value == other.value; }
+};
+
+TEST_CASE("BTree::insert() leaves the tree unchanged when copying the value throws", "[btree]")
+{
+    BTree<ThrowingCopyKey> tree;
+    for(int value : {0, 10, 20, 30})
+        tree.insert(value);
+
+    const ThrowingCopyKey five(5);
+    ThrowingCopyKey::throwOnCopy = true;
+    CHECK_THROWS_AS(tree.insert(five), std::bad_alloc);
+    ThrowingCopyKey::throwOnCopy = false;
+
+    std::vector<int> values;
+    for(auto it = tree.beginIterator(); it != tree.endIterator(); ++it)
+        values.push_back(it->value);
+
+    CHECK(values == std::vector<int>{0, 10, 20, 30});
+    CHECK(tree.size() == 4);
+    CHECK(tree.contains(30));
+    CHECK(tree.isValid());
+}
+
+TEST_CASE("BTree::Iterator keeps its path inline and can be copied", "[btree]")
+{
+    CHECK(SmallBTree::maximalHeight() == 64);
+    CHECK(BTree<int>::maximalHeight() < 64);
+
+    SmallBTree tree;
+    for(int i = 0; i < 5000; ++i)
+        tree.insert(i);
+
+    auto it = tree.beginIterator();
+    for(int i = 0; i < 1234; ++i)
+        ++it;
+
+    auto copy = it;
+    CHECK(*copy == 1234);
+
+    for(int i = 1234; i < 5000; ++i, ++it)
+        REQUIRE(*it == i);
+    CHECK(it == tree.endIterator());
+
+    // The copy has not been affected by advancing the original
+    CHECK(*copy == 1234);
+    ++copy;
+    CHECK(*copy == 1235);
+
+    copy = tree.endIterator();
+    CHECK(copy == it);
+}
+
+TEST_CASE("BTree::erase() keeps the tree valid", "[btree]")
+{
+    std::mt19937 generator(12345);
+    std::uniform_int_distribution<int> distribution(0, 300); // Many duplicates
+    SmallBTree tree;
+    std::multiset<int> expected;
+
+    for(int step = 0; step < 10000; ++step) {
+        const int value = distribution(generator);
+
+        if(step % 5 >= 3) {
+            tree.erase(value);
+            if(expected.count(value))
+                expected.erase(expected.find(value));
+        }
+        else {
+            tree.insert(value);
+            expected.insert(value);
+        }
+
+        REQUIRE(tree.isValid());
+        REQUIRE(tree.size() == expected.size());
+    }
+
+    CHECK(valuesOf(tree) == std::vector<int>(expected.begin(), expected.end()));
+
+    for(int value : std::vector<int>(expected.begin(), expected.end())) {
+        tree.erase(value);
+        REQUIRE(tree.isValid());
+    }
+
+    CHECK(tree.empty());
+    CHECK(tree.allocator().allocationsCount() == 0);
+}
+
+TEST_CASE("BTree::clear() releases all nodes", "[btree]")
+{
+    SmallBTree tree;
+    for(int i = 0; i < 100; ++i)
+        tree.insert(i);
+
+    CHECK(tree.allocator().allocationsCount() > 1);
+    tree.clear();
+    CHECK(tree.empty());
+    CHECK(tree.allocator().allocationsCount() == 0);
+}
+
+TEST_CASE("BTree can be copied", "[btree]")
+{
+    BTree<std::string, 128, PoolAllocator<BTreeNode<std::string, 128>>> tree;
+    for(int i = 0; i < 200; ++i)
+        tree.insert(std::to_string(i));
+
+    auto copy = tree;
+    CHECK(copy == tree);
+    CHECK(copy.isValid());
+    CHECK(copy.allocator().allocationsCount() == tree.allocator().allocationsCount());
+
+    copy.erase("100");
+    CHECK_FALSE(copy == tree);
+    CHECK(tree.contains("100"));
+
+    copy = tree;
+    CHECK(copy == tree);
+}
+
+/// Inserts random values and looks each of them up. Returns the elapsed times in seconds.
+template <typename Tree>
+std::pair<double, double> insertAndLookup(const std::vector<int>& values)
+{
+    Tree tree;
+
+    auto start = std::chrono::steady_clock::now();
+    for(int value : values)
+        tree.insert(value);
+    std::chrono::duration<double> insertion = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    size_t found = 0;
+    for(int value : values)
+        found += tree.contains(value);
+    std::chrono::duration<double> lookup = std::chrono::steady_clock::now() - start;
+
+    CHECK(found == values.size());
+    return { insertion.count(), lookup.count() };
+}
+
+//
+// This test is hidden. Run it explicitly with: unit-tests "[benchmark]"
+//
+TEST_CASE("Insertion and lookup with BTree and BinarySearchTree", "[.][benchmark]")
+{
+    const size_t size = GENERATE(100'000, 1'000'000, 10'000'000);
+    std::vector<int> values(size);
+    std::iota(values.begin(), values.end(), 0);
+    std::shuffle(values.begin(), values.end(), std::mt19937(42));
+
+    auto bst = insertAndLookup<BinarySearchTree<int, PoolNodeAllocator<int>, IterativeNodeOperations<int>>>(values);
+    auto avl = insertAndLookup<BinarySearchTree<int, PoolAllocator<AvlNode<int>>, AvlNodeOperations<int>>>(values);
+    auto btree = insertAndLookup<BTree<int, 256, PoolAllocator<BTreeNode<int, 256>>>>(values);
+    auto pageBtree = insertAndLookup<BTree<int, 4096, PoolAllocator<BTreeNode<int, 4096>>>>(values);
+
+    auto report = [size](const char* name, std::pair<double, double> times) {
+        return std::string(name) + ": " + std::to_string(size / times.first / 1e6) + " M inserts/s, "
+            + std::to_string(size / times.second / 1e6) + " M lookups/s\n";
+    };
+
+    WARN(size << " random values\n"
+        << report("BinarySearchTree", bst)
+        << report("BinarySearchTree with AVL", avl)
+        << report("BTree, 256 byte nodes", btree)
+        << report("BTree, 4096 byte nodes", pageBtree));
+}
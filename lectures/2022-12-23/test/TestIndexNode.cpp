@@ -0,0 +1,196 @@
+#include "catch2/catch_all.hpp"
+#include "Tree.h"
+
+#include <chrono>
+#include <random>
+#include <tuple>
+#include <vector>
+
+TEST_CASE("IndexNode<int> takes half the memory of Node<int>", "[IndexNode]")
+{
+    CHECK(sizeof(IndexNode<int>) == 12);
+    CHECK(sizeof(IndexNode<int>) * 2 <= sizeof(Node<int>));
+}
+
+TEST_CASE("IndexNodeHandle behaves like a pointer", "[IndexNode]")
+{
+    IndexNodeHandle<int> null;
+    CHECK(null == nullptr);
+    CHECK_FALSE(null);
+
+    IndexNodeAllocator<int> allocator;
+    IndexNodeHandle<int> node = allocator.buy();
+    CHECK(node != nullptr);
+    CHECK(node);
+    CHECK(node->isLeaf());
+    CHECK(node->data == 0);
+
+    (*node).data = 5;
+    CHECK(node->data == 5);
+
+    IndexNodeHandle<int> copy = node;
+    CHECK(copy == node);
+    CHECK(copy != null);
+
+    allocator.release(node);
+}
+
+TEST_CASE("IndexNodeAllocator allocates and releases correctly", "[IndexNode]")
+{
+    IndexNodeAllocator<int> allocator;
+    std::vector<IndexNodeHandle<int>> nodes;
+    const int count = 10'000; // More than one slab
+
+    for(int i = 0; i < count; ++i) {
+        nodes.push_back(allocator.buy());
+        nodes.back()->data = i;
+        CHECK(allocator.allocationsCount() == size_t(i + 1));
+    }
+
+    for(int i = 0; i < count; ++i)
+        CHECK(nodes[i]->data == i);
+
+    IndexNodeHandle<int> released = nodes.back();
+    allocator.release(released);
+    nodes.pop_back();
+    CHECK(allocator.buy() == released); // Released nodes are reused
+    nodes.push_back(released);
+
+    for(IndexNodeHandle<int> node : nodes)
+        allocator.release(node);
+
+    CHECK(allocator.allocationsCount() == 0);
+    CHECK_NOTHROW(allocator.release(nullptr));
+}
+
+TEST_CASE("Nodes of different IndexNodeAllocator objects do not overlap", "[IndexNode]")
+{
+    IndexNodeAllocator<int> first;
+    IndexNodeHandle<int> a = first.buy();
+    a->data = 1;
+
+    {
+        IndexNodeAllocator<int> second;
+        IndexNodeHandle<int> b = second.buy();
+        b->data = 2;
+        CHECK(a != b);
+        CHECK(a->data == 1);
+    } // The slab of the second allocator is freed here
+
+    IndexNodeAllocator<int> third; // May reuse the slab number of the second allocator
+    IndexNodeHandle<int> c = third.buy();
+    c->data = 3;
+    CHECK(a->data == 1);
+
+    third.release(c);
+    first.release(a);
+}
+
+TEST_CASE("IndexNodeSlabs grows its table when more slabs are needed", "[IndexNode]")
+{
+    IndexNodeAllocator<int> allocator;
+    std::vector<IndexNodeHandle<int>> nodes;
+    const int count = 100 * int(IndexNodeSlabs<int>::SlabSize); // The table doubles several times
+
+    for(int i = 0; i < count; ++i) {
+        nodes.push_back(allocator.buy());
+        nodes.back()->data = i;
+    }
+
+    bool allIntact = true;
+    for(int i = 0; i < count; ++i)
+        allIntact = allIntact && (nodes[i]->data == i);
+    CHECK(allIntact);
+
+    for(IndexNodeHandle<int> node : nodes)
+        allocator.release(node);
+    CHECK(allocator.allocationsCount() == 0);
+}
+
+using IndexTreeTypes = std::tuple<
+    BinarySearchTree<int, IndexNodeAllocator<int>, RecursiveNodeOperations<int, IndexNode<int>>>,
+    BinarySearchTree<int, IndexNodeAllocator<int>, IterativeNodeOperations<int, IndexNode<int>>>
+>;
+
+TEMPLATE_LIST_TEST_CASE("BinarySearchTree works with index-based nodes", "[IndexNode]", IndexTreeTypes)
+{
+    TestType bst;
+    std::vector<int> values{50, -3, 70, 30, 60, 90, 80};
+
+    for(int value : values)
+        bst.insert(value);
+
+    CHECK(bst.size() == values.size());
+    CHECK(bst.allocator().allocationsCount() == values.size());
+
+    for(int value : values)
+        CHECK(bst.contains(value));
+    CHECK_FALSE(bst.contains(1));
+
+    std::vector<int> visited;
+    for(auto it = bst.beginIterator(); it != bst.endIterator(); ++it)
+        visited.push_back(*it);
+    CHECK(visited == std::vector<int>{-3, 30, 50, 60, 70, 80, 90});
+
+    bst.erase(50);
+    bst.erase(80);
+    CHECK_FALSE(bst.contains(50));
+    CHECK_FALSE(bst.contains(80));
+    CHECK(bst.contains(90));
+    CHECK(bst.allocator().allocationsCount() == values.size() - 2);
+
+    bst.clear();
+    CHECK(bst.empty());
+    CHECK(bst.allocator().allocationsCount() == 0);
+}
+
+TEST_CASE("BinarySearchTree with index-based nodes can be copied", "[IndexNode]")
+{
+    BinarySearchTree<int, IndexNodeAllocator<int>, RecursiveNodeOperations<int, IndexNode<int>>> bst;
+    for(int value : {50, -3, 70, 30})
+        bst.insert(value);
+
+    auto copy = bst;
+    CHECK(copy == bst);
+
+    copy.erase(30);
+    CHECK_FALSE(copy == bst);
+}
+
+/// Builds a tree from random values, then looks up values and returns the elapsed time in seconds
+template <typename Bst>
+double insertAndLookup(size_t size)
+{
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> distribution;
+    Bst bst;
+
+    for(size_t i = 0; i < size; ++i)
+        bst.insert(distribution(generator));
+
+    auto start = std::chrono::steady_clock::now();
+    size_t found = 0;
+    for(size_t i = 0; i < size; ++i)
+        found += bst.contains(distribution(generator));
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    CHECK(found <= size);
+    return elapsed.count();
+}
+
+//
+// This test is hidden. Run it explicitly with: unit-tests "[benchmark]"
+//
+TEST_CASE("Lookup in trees of pointer-based and index-based nodes", "[.][benchmark]")
+{
+    const size_t size = GENERATE(1'000'000, 10'000'000);
+    const size_t pointerMemory = size * sizeof(Node<int>);
+    const size_t indexMemory = size * sizeof(IndexNode<int>);
+
+    const double pointerTime = insertAndLookup<BinarySearchTree<int, PoolNodeAllocator<int>, IterativeNodeOperations<int>>>(size);
+    const double indexTime = insertAndLookup<BinarySearchTree<int, IndexNodeAllocator<int>, IterativeNodeOperations<int, IndexNode<int>>>>(size);
+
+    WARN(size << " nodes: "
+        << "Node " << (pointerMemory >> 20) << " MB, " << (size / pointerTime / 1e6) << " M lookups/s; "
+        << "IndexNode " << (indexMemory >> 20) << " MB, " << (size / indexTime / 1e6) << " M lookups/s");
+}
@@ -1,7 +1,11 @@
 #include "catch2/catch_all.hpp"
+#include "AvlNodeOperations.h"
 #include "NodeIterator.h"
 #include "SampleTree.h"
 
+#include <chrono>
+#include <vector>
+
 
 TEST_CASE("NodeIterator::NodeIterator(nullptr) creates an iterator that has reached the end", "[tree]")
 {
@@ -43,4 +47,71 @@ TEST_CASE("NodeIterators pointing at the same node are equal", "[tree]")
     CHECK_FALSE(it1 != it2);
     CHECK(it1 == end);
     CHECK_FALSE(it1 != end);
-}
\ No newline at end of file
+}
+TEST_CASE("NodeIterator continues the path on the heap for trees deeper than its inline capacity", "[tree]")
+{
+    // A degenerate tree, where every node is the left successor of the previous one
+    std::vector<Node<int>> nodes(100);
+    for(int i = 0; i < 100; ++i) {
+        nodes[i].data = 99 - i;
+        nodes[i].left = (i + 1 < 100) ? &nodes[i + 1] : nullptr;
+    }
+
+    NodeIterator<int, Node<int>, 4> it(&nodes[0]);
+    NodeIterator<int> deep(&nodes[0]);
+
+    for(int expected = 0; expected < 100; ++expected, ++it, ++deep) {
+        REQUIRE_FALSE(it.atEnd());
+        CHECK(it->data == expected);
+        CHECK(deep->data == expected);
+
+        if(expected == 50) {
+            NodeIterator<int, Node<int>, 4> copy = it;
+            ++copy;
+            CHECK(copy->data == 51);
+        }
+    }
+
+    CHECK(it.atEnd());
+    CHECK(deep.atEnd());
+}
+
+/// Sums the values of a tree `repetitions` times with a given iterator type and returns the time in ms
+template <typename Iterator, typename Handle>
+static double sumWithIterator(Handle rootptr, int repetitions, long long& sum)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    for(int i = 0; i < repetitions; ++i)
+        for(Iterator it(rootptr); ! it.atEnd(); ++it)
+            sum += it->data;
+
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+//
+// This test is hidden. Run it explicitly with: unit-tests "[benchmark]"
+//
+TEST_CASE("Iterating trees of different sizes with NodeIterator", "[.][benchmark]")
+{
+    const int size = GENERATE(10, 1000, 1'000'000);
+    const int repetitions = 10'000'000 / size;
+
+    // A perfectly balanced tree of the values 0..size-1
+    std::vector<AvlNode<int>> nodes(size);
+    for(int i = 0; i < size; ++i) {
+        nodes[i].data = i;
+        nodes[i].right = (i + 1 < size) ? &nodes[i + 1] : nullptr;
+    }
+    AvlNode<int>* rootptr = AvlNodeOperations<int>::fromSortedList(&nodes[0], size);
+
+    long long sumOnHeap = 0;
+    long long sumInline = 0;
+    const double onHeap = sumWithIterator<NodeIterator<int, AvlNode<int>, 0>>(rootptr, repetitions, sumOnHeap);
+    const double inlinePath = sumWithIterator<NodeIterator<int, AvlNode<int>>>(rootptr, repetitions, sumInline);
+
+    CHECK(sumOnHeap == repetitions * (static_cast<long long>(size) * (size - 1) / 2));
+    CHECK(sumInline == sumOnHeap);
+    WARN("Iterating " << repetitions << " times over " << size << " values: path on the heap "
+        << onHeap << " ms, inline path " << inlinePath << " ms");
+}
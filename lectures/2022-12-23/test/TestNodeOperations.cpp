@@ -2,6 +2,11 @@
 #include "NodeOperations.h"
 #include "SampleTree.h"
 
+#include <algorithm>
+#include <new>
+#include <random>
+#include <vector>
+
 using TreeOperationTypes = std::tuple<
 	IterativeNodeOperations<int>,
 	RecursiveNodeOperations<int>
@@ -353,4 +358,265 @@ TEMPLATE_LIST_TEST_CASE(
 	CHECK(TestType::sameTrees(cloned, tree.rootptr));
 	CHECK(da.allocationsCount() == tree.values.size());
 	CHECK(da.totalAllocationsCount() == tree.values.size());
-}
\ No newline at end of file
+}
+/// Allocates copies of the nodes of a SampleTree with a given allocator
+template <typename Operations, typename AllocatorType>
+Node<int>* buildSampleTree(AllocatorType& allocator)
+{
+	SampleTree sample;
+	Node<int>* rootptr = nullptr;
+
+	// Inserting in breadth-first order reproduces the shape of the sample tree
+	for(int value : {50, -3, 70, 30, 60, 90, 80}) {
+		Node<int>* node = allocator.buy();
+		node->data = value;
+		Operations::insert(rootptr, *node);
+	}
+
+	REQUIRE(Operations::sameTrees(rootptr, sample.rootptr));
+	return rootptr;
+}
+
+TEMPLATE_LIST_TEST_CASE(
+	"TreeOperation::relocate() moves the nodes to a block in in-order sequence and keeps the shape of the tree",
+	"[tree]",
+	TreeOperationTypes)
+{
+	SampleTree sample;
+	DebugAllocator<Node<int>> da;
+	Node<int>* rootptr = buildSampleTree<TestType>(da);
+
+	std::vector<Node<int>> block(sample.values.size());
+	rootptr = TestType::relocate(rootptr, block.data(), da);
+
+	CHECK(TestType::sameTrees(rootptr, sample.rootptr));
+	CHECK(da.allocationsCount() == 0); // All old nodes have been released
+
+	for(size_t i = 0; i < block.size(); ++i)
+		CHECK(block[i].data == sample.values[i]);
+
+	CHECK(rootptr == &block[2]); // 50 is the third smallest value
+}
+
+TEMPLATE_LIST_TEST_CASE(
+	"TreeOperation::relocate() returns nullptr for an empty tree",
+	"[tree]",
+	TreeOperationTypes)
+{
+	DebugAllocator<Node<int>> da;
+	CHECK(TestType::relocate(nullptr, nullptr, da) == nullptr);
+}
+
+/// Allocator, which fails with std::bad_alloc once it has made a given number of allocations
+class FailingAllocator : public DebugAllocator<Node<int>> {
+	size_t m_remaining;
+
+public:
+	FailingAllocator(size_t allocationsBeforeFailure)
+		: m_remaining(allocationsBeforeFailure)
+	{
+	}
+
+	template <typename... Args>
+	Node<int>* buy(Args&&... args)
+	{
+		if(m_remaining == 0)
+			throw std::bad_alloc();
+
+		--m_remaining;
+		return DebugAllocator<Node<int>>::buy(std::forward<Args>(args)...);
+	}
+};
+
+TEMPLATE_LIST_TEST_CASE(
+	"TreeOperation::clone() leaves the source unchanged and leaks nothing when allocation fails",
+	"[tree]",
+	TreeOperationTypes)
+{
+	SampleTree tree;
+	SampleTree unchanged;
+
+	for(size_t failAt = 0; failAt < tree.values.size(); ++failAt) {
+		FailingAllocator fa(failAt);
+
+		CHECK_THROWS_AS(TestType::clone(tree.rootptr, fa), std::bad_alloc);
+		CHECK(TestType::sameTrees(tree.rootptr, unchanged.rootptr));
+		CHECK(fa.allocationsCount() == 0);
+	}
+}
+
+/// Builds a degenerate tree, which zig-zags for `size` levels, e.g. 0, size, 1, size-1, ...
+template <typename AllocatorType>
+Node<int>* buildZigZagTree(int size, AllocatorType& allocator)
+{
+	Node<int>* rootptr = nullptr;
+	Node<int>** position = &rootptr;
+
+	for(int low = 0, high = size - 1; low <= high; ++low, --high) {
+		*position = allocator.buy(low);
+		position = &(*position)->right;
+
+		if(low != high) {
+			*position = allocator.buy(high);
+			position = &(*position)->left;
+		}
+	}
+
+	return rootptr;
+}
+
+TEST_CASE("IterativeNodeOperations::clone() and release() work for trees too deep for recursion", "[tree]")
+{
+	PoolAllocator<Node<int>> pa;
+	const int size = 1'000'000;
+	Node<int>* rootptr = buildZigZagTree(size, pa);
+
+	Node<int>* cloned = IterativeNodeOperations<int>::clone(rootptr, pa);
+
+	CHECK(pa.allocationsCount() == 2 * size);
+	CHECK(IterativeNodeOperations<int>::sameTrees(cloned, rootptr));
+
+	IterativeNodeOperations<int>::release(cloned, pa);
+	IterativeNodeOperations<int>::release(rootptr, pa);
+	CHECK(pa.allocationsCount() == 0);
+}
+
+//
+// This test is hidden. Run it explicitly with: unit-tests "[benchmark]"
+//
+TEST_CASE("Recursive and iterative cloning of a large random tree", "[.][benchmark]")
+{
+	const int size = 1'000'000;
+	std::vector<int> values(size);
+	for(int i = 0; i < size; ++i)
+		values[i] = i;
+	std::shuffle(values.begin(), values.end(), std::mt19937(42));
+
+	PoolAllocator<Node<int>> pa;
+	Node<int>* rootptr = nullptr;
+	for(int value : values)
+		IterativeNodeOperations<int>::insert(rootptr, pa.buy(value));
+
+	BENCHMARK_ADVANCED("RecursiveNodeOperations::clone()")(Catch::Benchmark::Chronometer meter)
+	{
+		PoolAllocator<Node<int>> target;
+		Node<int>* cloned = nullptr;
+		meter.measure([&] { cloned = RecursiveNodeOperations<int>::clone(rootptr, target); });
+		RecursiveNodeOperations<int>::release(cloned, target);
+	};
+
+	BENCHMARK_ADVANCED("IterativeNodeOperations::clone()")(Catch::Benchmark::Chronometer meter)
+	{
+		PoolAllocator<Node<int>> target;
+		Node<int>* cloned = nullptr;
+		meter.measure([&] { cloned = IterativeNodeOperations<int>::clone(rootptr, target); });
+		IterativeNodeOperations<int>::release(cloned, target);
+	};
+
+	IterativeNodeOperations<int>::release(rootptr, pa);
+}
+
+/// Number of levels of a tree
+int heightOf(const Node<int>* node)
+{
+	return node ? 1 + std::max(heightOf(node->left), heightOf(node->right)) : 0;
+}
+
+TEMPLATE_LIST_TEST_CASE(
+	"TreeOperation::fromSortedList() builds a tree of minimal height with the values in the same order",
+	"[tree]",
+	TreeOperationTypes)
+{
+	for(int size = 0; size <= 100; ++size) {
+		std::vector<Node<int>> nodes(size);
+		for(int i = 0; i < size; ++i) {
+			nodes[i].data = i;
+			nodes[i].right = (i + 1 < size) ? &nodes[i + 1] : nullptr;
+		}
+
+		Node<int>* rootptr = TestType::fromSortedList(size ? &nodes[0] : nullptr, size);
+
+		int minimalHeight = 0;
+		while((1 << minimalHeight) <= size)
+			++minimalHeight;
+
+		CHECK(heightOf(rootptr) == minimalHeight);
+
+		int expected = 0;
+		for(NodeIterator<int> it(rootptr); ! it.atEnd(); ++it)
+			CHECK(it->data == expected++);
+		CHECK(expected == size);
+	}
+}
+
+TEMPLATE_LIST_TEST_CASE(
+	"TreeOperation::toSortedList() links all nodes in in-order sequence",
+	"[tree]",
+	TreeOperationTypes)
+{
+	SampleTree sample;
+	DebugAllocator<Node<int>> da;
+	Node<int>* rootptr = buildSampleTree<TestType>(da);
+
+	Node<int>* list = TestType::toSortedList(rootptr);
+
+	size_t count = 0;
+	for(Node<int>* node = list; node; node = node->right) {
+		REQUIRE(count < sample.values.size());
+		CHECK(node->data == sample.values[count++]);
+		CHECK(node->left == nullptr);
+	}
+	CHECK(count == sample.values.size());
+	CHECK(TestType::toSortedList(nullptr) == nullptr);
+
+	TestType::release(TestType::fromSortedList(list, count), da);
+	CHECK(da.allocationsCount() == 0);
+}
+
+TEMPLATE_LIST_TEST_CASE(
+	"TreeOperation::split() separates the smaller and the larger values",
+	"[tree]",
+	TreeOperationTypes)
+{
+	SampleTree t;
+	Node<int>* smaller = nullptr;
+	Node<int>* larger = nullptr;
+
+	SECTION("Value in the tree") {
+		Node<int>* found = TestType::split(t.rootptr, t.f.data, smaller, larger);
+
+		REQUIRE(found == &t.f);
+		CHECK(found->isLeaf());
+		smaller = TestType::toSortedList(smaller);
+		CHECK(smaller == &t.b);
+		CHECK(larger == nullptr);
+
+		// Joining the parts back restores all values
+		Node<int>* list = TestType::toSortedList(TestType::join(smaller, found, larger));
+		for(int value : t.values) {
+			REQUIRE(list != nullptr);
+			CHECK(list->data == value);
+			list = list->right;
+		}
+	}
+	SECTION("Value not in the tree") {
+		Node<int>* found = TestType::split(t.rootptr, t.d.data + 1, smaller, larger);
+
+		CHECK(found == nullptr);
+		CHECK(TestType::findPointerToLargest(smaller) == &t.d);
+		larger = TestType::toSortedList(larger);
+		CHECK(larger == &t.a);
+
+		Node<int>* list = TestType::toSortedList(TestType::join(smaller, larger));
+		for(int value : t.values) {
+			REQUIRE(list != nullptr);
+			CHECK(list->data == value);
+			list = list->right;
+		}
+	}
+	SECTION("Empty tree") {
+		CHECK(TestType::split(nullptr, 0, smaller, larger) == nullptr);
+		CHECK(smaller == nullptr);
+		CHECK(larger == nullptr);
+	}
+}
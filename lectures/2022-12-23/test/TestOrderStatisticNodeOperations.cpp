@@ -0,0 +1,171 @@
+#include "catch2/catch_all.hpp"
+#include "Tree.h"
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <random>
+#include <set>
+#include <vector>
+
+using OrderStatisticOperations = OrderStatisticNodeOperations<int>;
+using OrderStatisticBst = BinarySearchTree<int, PoolAllocator<OrderStatisticNode<int>>, OrderStatisticOperations>;
+
+/// Even values 0, 2, ..., 2 * (count - 1) in random order
+static std::vector<int> shuffledEvenValues(int count)
+{
+    std::vector<int> values(count);
+    for(int i = 0; i < count; ++i)
+        values[i] = 2 * i;
+
+    std::shuffle(values.begin(), values.end(), std::mt19937(42));
+    return values;
+}
+
+TEST_CASE("OrderStatisticNodeOperations::insert() and extract() keep the subtree sizes", "[order-statistic]")
+{
+    PoolAllocator<OrderStatisticNode<int>> allocator;
+    OrderStatisticNode<int>* rootptr = nullptr;
+    const std::vector<int> values = shuffledEvenValues(500);
+
+    for(int value : values) {
+        OrderStatisticOperations::insert(rootptr, allocator.buy(value));
+        REQUIRE(OrderStatisticOperations::isValid(rootptr));
+    }
+
+    CHECK(OrderStatisticOperations::size(rootptr) == values.size());
+
+    for(size_t i = 0; i < values.size(); i += 2) {
+        allocator.release(OrderStatisticOperations::extract(rootptr, values[i]));
+        REQUIRE(OrderStatisticOperations::isValid(rootptr));
+    }
+
+    CHECK(OrderStatisticOperations::size(rootptr) == values.size() / 2);
+    OrderStatisticOperations::release(rootptr, allocator);
+}
+
+TEST_CASE("OrderStatisticNodeOperations::select() finds the k-th smallest value", "[order-statistic]")
+{
+    PoolAllocator<OrderStatisticNode<int>> allocator;
+    OrderStatisticNode<int>* rootptr = nullptr;
+
+    CHECK(OrderStatisticOperations::select(rootptr, 0) == nullptr);
+
+    for(int value : shuffledEvenValues(300))
+        OrderStatisticOperations::insert(rootptr, allocator.buy(value));
+
+    for(size_t k = 0; k < 300; ++k) {
+        REQUIRE(OrderStatisticOperations::select(rootptr, k) != nullptr);
+        CHECK(OrderStatisticOperations::select(rootptr, k)->data == int(2 * k));
+    }
+
+    CHECK(OrderStatisticOperations::select(rootptr, 300) == nullptr);
+    OrderStatisticOperations::release(rootptr, allocator);
+}
+
+TEST_CASE("OrderStatisticNodeOperations::rank() and countInRange() count the values", "[order-statistic]")
+{
+    PoolAllocator<OrderStatisticNode<int>> allocator;
+    OrderStatisticNode<int>* rootptr = nullptr;
+
+    for(int value : shuffledEvenValues(100)) // 0, 2, ..., 198
+        OrderStatisticOperations::insert(rootptr, allocator.buy(value));
+
+    CHECK(OrderStatisticOperations::rank(rootptr, -5) == 0);
+    CHECK(OrderStatisticOperations::rank(rootptr, 0) == 0);
+    CHECK(OrderStatisticOperations::rank(rootptr, 1) == 1);
+    CHECK(OrderStatisticOperations::rank(rootptr, 10) == 5);
+    CHECK(OrderStatisticOperations::rank(rootptr, 1000) == 100);
+
+    CHECK(OrderStatisticOperations::countInRange(rootptr, 10, 20) == 6);
+    CHECK(OrderStatisticOperations::countInRange(rootptr, 11, 19) == 4);
+    CHECK(OrderStatisticOperations::countInRange(rootptr, 10, 10) == 1);
+    CHECK(OrderStatisticOperations::countInRange(rootptr, 11, 11) == 0);
+    CHECK(OrderStatisticOperations::countInRange(rootptr, 20, 10) == 0);
+    CHECK(OrderStatisticOperations::countInRange(rootptr, -100, 1000) == 100);
+
+    OrderStatisticOperations::release(rootptr, allocator);
+}
+
+TEST_CASE("BinarySearchTree works with OrderStatisticNodeOperations", "[order-statistic]")
+{
+    OrderStatisticBst bst;
+    const std::vector<int> values = shuffledEvenValues(1000);
+
+    SECTION("insert() and erase()") {
+        for(int value : values)
+            bst.insert(value);
+        for(int value = 0; value < 2000; value += 4)
+            bst.erase(value);
+
+        // Values 2, 6, 10, ... remain
+        CHECK(bst.size() == 500);
+        CHECK(bst.select(0) == 2);
+        CHECK(bst.select(499) == 1998);
+        CHECK(bst.rank(10) == 2);
+        CHECK(bst.countInRange(0, 100) == 25);
+        CHECK_THROWS_AS(bst.select(500), std::out_of_range);
+    }
+    SECTION("Bulk operations") {
+        bst.assign(values.begin(), values.end());
+        CHECK(bst.select(123) == 246);
+
+        std::vector<int> odd(100);
+        for(int i = 0; i < 100; ++i)
+            odd[i] = 2 * i + 1;
+
+        bst.insertBatch(odd.begin(), odd.end());
+        CHECK(bst.size() == 1100);
+        CHECK(bst.select(199) == 199);
+        CHECK(bst.rank(200) == 200);
+
+        OrderStatisticBst other;
+        other.assign(odd.begin(), odd.end());
+        bst.difference(other);
+        CHECK(bst.size() == 1000);
+        CHECK(bst.select(100) == 200);
+
+        const OrderStatisticBst copy = bst;
+        CHECK(copy.select(999) == 1998);
+        CHECK(copy.countInRange(1000, 1998) == 500);
+    }
+}
+
+//
+// This test is hidden. Run it explicitly with: unit-tests "[benchmark]"
+//
+TEST_CASE("Finding the k-th value by iterating and with select()", "[.][benchmark]")
+{
+    const int count = 1'000'000;
+    const std::vector<int> values = shuffledEvenValues(count);
+    std::vector<size_t> positions(1000);
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<size_t> distribution(0, count - 1);
+    for(size_t& k : positions)
+        k = distribution(generator);
+
+    BinarySearchTree<int, PoolAllocator<AvlNode<int>>, AvlNodeOperations<int>> avl;
+    OrderStatisticBst bst;
+    avl.assign(values.begin(), values.end());
+    bst.assign(values.begin(), values.end());
+
+    long long sumByIterating = 0;
+    auto start = std::chrono::steady_clock::now();
+    for(size_t k : positions) {
+        auto it = avl.beginIterator();
+        for(size_t i = 0; i < k; ++i)
+            ++it;
+        sumByIterating += *it;
+    }
+    std::chrono::duration<double> iterating = std::chrono::steady_clock::now() - start;
+
+    long long sumBySelecting = 0;
+    start = std::chrono::steady_clock::now();
+    for(size_t k : positions)
+        sumBySelecting += bst.select(k);
+    std::chrono::duration<double> selecting = std::chrono::steady_clock::now() - start;
+
+    CHECK(sumByIterating == sumBySelecting);
+    WARN("Finding " << positions.size() << " values by position in a tree of " << count << " values: "
+        << "iterating " << iterating.count() * 1000 << " ms, select() " << selecting.count() * 1000 << " ms");
+}
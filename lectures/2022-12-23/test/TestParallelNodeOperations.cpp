@@ -0,0 +1,151 @@
+#include "catch2/catch_all.hpp"
+#include "Tree.h"
+
+#include <chrono>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using ParallelBst = BinarySearchTree<int, ThreadCachingAllocator<Node<int>>, IterativeNodeOperations<int>>;
+using ParallelAvlBst = BinarySearchTree<int, LockFreeAllocator<AvlNode<int>>, AvlNodeOperations<int>>;
+
+using ParallelTreeTypes = std::tuple<ParallelBst, ParallelAvlBst>;
+
+/// A tree with the values 0..count-1, inserted in random order
+template <typename Bst>
+static void fillRandomly(Bst& bst, int count)
+{
+    std::vector<int> values(count);
+    std::iota(values.begin(), values.end(), 0);
+    std::shuffle(values.begin(), values.end(), std::mt19937(42));
+
+    for(int value : values)
+        bst.insert(value);
+}
+
+TEMPLATE_LIST_TEST_CASE("Parallel clone, equality, reduce and clear of BinarySearchTree", "[parallel]", ParallelTreeTypes)
+{
+    const unsigned threads = GENERATE(1, 3, 4);
+    WorkStealingPool pool(threads);
+
+    TestType bst;
+    fillRandomly(bst, 10'000);
+    const size_t allocations = bst.allocator().allocationsCount();
+
+    TestType copy(bst, pool);
+    CHECK(copy.size() == bst.size());
+    CHECK(copy == bst);
+    CHECK(copy.equals(bst, pool));
+    CHECK(copy.allocator().allocationsCount() == allocations);
+
+    const long long sum = copy.parallelReduce(pool, 0LL, [](int value) { return static_cast<long long>(value); }, std::plus<>());
+    CHECK(sum == 10'000LL * 9'999 / 2);
+
+    // Concatenating the values in order shows that the order of combining is kept
+    std::vector<int> inOrder = copy.parallelReduce(pool, std::vector<int>(),
+        [](int value) { return std::vector<int>{value}; },
+        [](std::vector<int> a, const std::vector<int>& b) { a.insert(a.end(), b.begin(), b.end()); return a; });
+    std::vector<int> expected(10'000);
+    std::iota(expected.begin(), expected.end(), 0);
+    CHECK(inOrder == expected);
+
+    copy.erase(5000);
+    copy.insert(5000);
+    if constexpr (std::is_same_v<TestType, ParallelBst>)
+        CHECK_FALSE(copy.equals(bst, pool)); // The node with 5000 moved to a leaf
+
+    copy.clear(pool);
+    CHECK(copy.empty());
+    CHECK(copy.allocator().allocationsCount() == 0);
+}
+
+TEST_CASE("Parallel operations on empty trees", "[parallel]")
+{
+    WorkStealingPool pool(2);
+    ParallelBst empty;
+    ParallelBst copy(empty, pool);
+
+    CHECK(copy.empty());
+    CHECK(copy.equals(empty, pool));
+    CHECK(copy.parallelReduce(pool, 0, [](int value) { return value; }, std::plus<>()) == 0);
+    copy.clear(pool);
+}
+
+//
+// This test is hidden. Run it explicitly with: unit-tests "[benchmark]"
+//
+TEST_CASE("Scaling of parallel tree operations with the number of threads", "[.][benchmark]")
+{
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+    const int size = 4'000'000;
+
+    std::vector<int> values(size);
+    std::iota(values.begin(), values.end(), 0);
+    ParallelBst bst;
+    bst.assign(values.begin(), values.end());
+
+    // The first copy takes the slabs for its nodes from the system. Later copies reuse them.
+    {
+        ParallelBst warmUp(bst);
+    }
+
+    // The sequential operations, for comparison
+    {
+        auto start = std::chrono::steady_clock::now();
+        ParallelBst copy(bst);
+        const double clone = Milliseconds(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        const bool same = (copy == bst);
+        const double equality = Milliseconds(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        long long sum = 0;
+        for(auto it = copy.beginIterator(); it != copy.endIterator(); ++it)
+            sum += *it;
+        const double reduce = Milliseconds(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        copy.clear();
+        const double release = Milliseconds(std::chrono::steady_clock::now() - start).count();
+
+        CHECK(same);
+        CHECK(sum == static_cast<long long>(size) * (size - 1) / 2);
+        WARN(size << " nodes, sequential: clone " << clone << " ms, equality "
+            << equality << " ms, reduce " << reduce << " ms, release " << release << " ms");
+    }
+
+    const unsigned maximalThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    // Powers of two and the number of hardware threads, also if it is not a power of two
+    std::vector<unsigned> threadCounts;
+    for(unsigned threads = 1; threads < maximalThreads; threads *= 2)
+        threadCounts.push_back(threads);
+    threadCounts.push_back(maximalThreads);
+
+    for(unsigned threads : threadCounts) {
+        WorkStealingPool pool(threads);
+
+        auto start = std::chrono::steady_clock::now();
+        ParallelBst copy(bst, pool);
+        const double clone = Milliseconds(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        const bool same = copy.equals(bst, pool);
+        const double equality = Milliseconds(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        const long long sum = copy.parallelReduce(pool, 0LL, [](int value) { return static_cast<long long>(value); }, std::plus<>());
+        const double reduce = Milliseconds(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        copy.clear(pool);
+        const double release = Milliseconds(std::chrono::steady_clock::now() - start).count();
+
+        CHECK(same);
+        CHECK(sum == static_cast<long long>(size) * (size - 1) / 2);
+        WARN(size << " nodes on " << threads << " threads: clone " << clone << " ms, equality "
+            << equality << " ms, reduce " << reduce << " ms, release " << release << " ms");
+    }
+}
@@ -0,0 +1,204 @@
+#include "catch2/catch_all.hpp"
+#include "Tree.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using SplayOperations = SplayNodeOperations<int>;
+
+/// Values of the tree in in-order sequence
+template <typename NodeType>
+std::vector<int> inOrder(typename NodeType::Handle rootptr)
+{
+    std::vector<int> values;
+    for(NodeIterator<int, NodeType> it(rootptr); ! it.atEnd(); ++it)
+        values.push_back(it->data);
+    return values;
+}
+
+TEST_CASE("SplayNodeOperations::findPointerTo() moves the found node to the root", "[splay]")
+{
+    PoolNodeAllocator<int> allocator;
+    Node<int>* rootptr = nullptr;
+
+    for(int i = 0; i < 100; ++i)
+        SplayOperations::insert(rootptr, allocator.buy(i));
+
+    for(int value : {0, 50, 99, 17, 17}) {
+        Node<int>*& found = SplayOperations::findPointerTo(value, rootptr);
+        CHECK(&found == &rootptr);
+        CHECK(rootptr->data == value);
+    }
+
+    std::vector<int> expected(100);
+    std::iota(expected.begin(), expected.end(), 0);
+    CHECK(inOrder<Node<int>>(rootptr) == expected);
+
+    SplayOperations::release(rootptr, allocator);
+}
+
+TEST_CASE("SplayNodeOperations::findPointerTo() returns the position for a missing value", "[splay]")
+{
+    PoolNodeAllocator<int> allocator;
+    Node<int>* rootptr = nullptr;
+
+    CHECK(SplayOperations::findPointerTo(1, rootptr) == nullptr);
+
+    for(int i = 0; i < 100; i += 2)
+        SplayOperations::insert(rootptr, allocator.buy(i));
+
+    for(int value : {-1, 51, 101}) {
+        Node<int>*& position = SplayOperations::findPointerTo(value, rootptr);
+        REQUIRE(position == nullptr);
+
+        position = allocator.buy(value); // The value can be inserted at that position
+        std::vector<int> values = inOrder<Node<int>>(rootptr);
+        CHECK(std::is_sorted(values.begin(), values.end()));
+        CHECK(SplayOperations::findPointerTo(value, rootptr) == rootptr);
+    }
+
+    SplayOperations::release(rootptr, allocator);
+}
+
+TEST_CASE("SplayNodeOperations::insert() and extract() keep the tree sorted", "[splay]")
+{
+    std::mt19937 generator(12345);
+    std::uniform_int_distribution<int> distribution(0, 200); // Many duplicates
+    PoolNodeAllocator<int> allocator;
+    Node<int>* rootptr = nullptr;
+    std::multiset<int> expected;
+
+    for(int step = 0; step < 5000; ++step) {
+        const int value = distribution(generator);
+
+        if(step % 3 == 2) {
+            Node<int>* extracted = SplayOperations::extract(rootptr, value);
+            auto it = expected.find(value);
+
+            if(it == expected.end()) {
+                REQUIRE(extracted == nullptr);
+            }
+            else {
+                REQUIRE(extracted != nullptr);
+                CHECK(extracted->data == value);
+                CHECK(extracted->isLeaf());
+                expected.erase(it);
+                allocator.release(extracted);
+            }
+        }
+        else {
+            SplayOperations::insert(rootptr, allocator.buy(value));
+            REQUIRE(rootptr->data == value);
+            expected.insert(value);
+        }
+    }
+
+    CHECK(inOrder<Node<int>>(rootptr) == std::vector<int>(expected.begin(), expected.end()));
+    CHECK(allocator.allocationsCount() == expected.size());
+
+    SplayOperations::release(rootptr, allocator);
+}
+
+using SplayTreeTypes = std::tuple<
+    BinarySearchTree<int, PoolNodeAllocator<int>, SplayNodeOperations<int>>,
+    BinarySearchTree<int, IndexNodeAllocator<int>, SplayNodeOperations<int, IndexNode<int>>>
+>;
+
+TEMPLATE_LIST_TEST_CASE("BinarySearchTree works with SplayNodeOperations", "[splay]", SplayTreeTypes)
+{
+    TestType bst;
+
+    for(int i = 0; i < 100; ++i)
+        bst.insert(i);
+
+    for(int i = 0; i < 100; i += 2)
+        bst.erase(i);
+
+    CHECK(bst.size() == 50);
+    CHECK(bst.allocator().allocationsCount() == 50);
+
+    for(int i = 0; i < 100; ++i)
+        CHECK(bst.contains(i) == (i % 2 == 1));
+
+    int expected = 1;
+    for(auto it = bst.beginIterator(); it != bst.endIterator(); ++it, expected += 2)
+        CHECK(*it == expected);
+
+    TestType copy(bst);
+    CHECK(copy == bst);
+
+    bst.clear();
+    CHECK(bst.allocator().allocationsCount() == 0);
+}
+
+/// Draws ranks in [0, n) with P(k) proportional to 1 / (k + 1)^s
+class ZipfDistribution {
+    std::vector<double> cumulative;
+
+public:
+    ZipfDistribution(size_t n, double s)
+        : cumulative(n)
+    {
+        double sum = 0;
+        for(size_t k = 0; k < n; ++k)
+            cumulative[k] = sum += 1.0 / std::pow(k + 1.0, s);
+    }
+
+    template <typename Generator>
+    size_t operator()(Generator& generator) const
+    {
+        std::uniform_real_distribution<double> distribution(0, cumulative.back());
+        auto it = std::lower_bound(cumulative.begin(), cumulative.end(), distribution(generator));
+        return std::min<size_t>(it - cumulative.begin(), cumulative.size() - 1);
+    }
+};
+
+//
+// This test is hidden. Run it explicitly with: unit-tests "[benchmark]"
+//
+TEST_CASE("Zipf-distributed lookups with plain, AVL and splay trees", "[.][benchmark]")
+{
+    const int size = 1'000'000;
+    const int queryCount = 1'000'000;
+    const double exponent = GENERATE(1.1, 1.5);
+    std::mt19937 generator(42);
+
+    std::vector<int> keys(size);
+    std::iota(keys.begin(), keys.end(), 0);
+    std::shuffle(keys.begin(), keys.end(), generator);
+
+    // The hot keys are scattered over the whole tree
+    ZipfDistribution zipf(size, exponent);
+    std::vector<int> queries(queryCount);
+    for(int& query : queries)
+        query = keys[zipf(generator)];
+
+    BinarySearchTree<int, PoolNodeAllocator<int>, IterativeNodeOperations<int>> plain;
+    BinarySearchTree<int, PoolAllocator<AvlNode<int>>, AvlNodeOperations<int>> avl;
+    BinarySearchTree<int, PoolNodeAllocator<int>, SplayNodeOperations<int>> splay;
+
+    for(int key : keys) {
+        plain.insert(key);
+        avl.insert(key);
+        splay.insert(key);
+    }
+
+    auto lookup = [&queries](auto& bst) {
+        size_t found = 0;
+        for(int query : queries)
+            found += bst.contains(query);
+        return found;
+    };
+
+    const std::string suffix = ", Zipf exponent " + std::to_string(exponent).substr(0, 3);
+
+    BENCHMARK("IterativeNodeOperations" + suffix) { return lookup(plain); };
+    BENCHMARK("AvlNodeOperations" + suffix) { return lookup(avl); };
+    BENCHMARK("SplayNodeOperations" + suffix) { return lookup(splay); };
+}
@@ -1,6 +1,19 @@
 #include "catch2/catch_all.hpp"
 #include "Tree.h"
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <new>
+#include <numeric>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
 using DebugBst = BinarySearchTree<int, DebugNodeAllocator<int>>;
 
 TEST_CASE("BinarySearchTree::BinarySearchTree() constructs an empty tree", "[tree]")
@@ -65,6 +78,75 @@ TEST_CASE("BinarySearchTree::insert() results in exactly one new allocation", "[
     }
 }
 
+/// A value, which counts how many times objects of its type have been created in different ways
+struct CountedValue {
+    static inline int copies = 0;
+    static inline int moves = 0;
+    static inline int defaultConstructions = 0;
+
+    std::string text;
+
+    CountedValue() { ++defaultConstructions; }
+    CountedValue(size_t count, char c) : text(count, c) {}
+    CountedValue(const CountedValue& other) : text(other.text) { ++copies; }
+    CountedValue(CountedValue&& other) noexcept : text(std::move(other.text)) { ++moves; }
+    CountedValue& operator=(const CountedValue& other) { text = other.text; ++copies; return *this; }
+    CountedValue& operator=(CountedValue&& other) noexcept { text = std::move(other.text); ++moves; return *this; }
+
+    bool operator<(const CountedValue& other) const { return text < other.text; }
+    bool operator==(const CountedValue& other) const { return text == other.text; }
+    bool operator!=(const CountedValue& other) const { return text != other.text; }
+
+    static void resetCounters()
+    {
+        copies = moves = defaultConstructions = 0;
+    }
+};
+
+TEST_CASE("BinarySearchTree constructs each node exactly once from the inserted value", "[tree]")
+{
+    BinarySearchTree<CountedValue, PoolNodeAllocator<CountedValue>> bst;
+    const CountedValue value(3, 'b');
+
+    CountedValue::resetCounters();
+
+    SECTION("insert(const T&) copies the value once") {
+        bst.insert(value);
+        CHECK(CountedValue::copies == 1);
+        CHECK(CountedValue::moves == 0);
+    }
+    SECTION("insert(T&&) moves the value once") {
+        CountedValue temporary(3, 'b');
+        bst.insert(std::move(temporary));
+        CHECK(CountedValue::copies == 0);
+        CHECK(CountedValue::moves == 1);
+        CHECK(temporary.text.empty());
+    }
+    SECTION("emplace() constructs the value in the node") {
+        bst.emplace(3, 'b');
+        CHECK(CountedValue::copies == 0);
+        CHECK(CountedValue::moves == 0);
+    }
+
+    CHECK(CountedValue::defaultConstructions == 0);
+    CHECK(bst.size() == 1);
+    CHECK(bst.contains(value));
+}
+
+TEST_CASE("Copying a BinarySearchTree copies each value once", "[tree]")
+{
+    BinarySearchTree<CountedValue, PoolNodeAllocator<CountedValue>> bst;
+    for(char c : {'m', 'c', 'x', 'a'})
+        bst.emplace(2, c);
+
+    CountedValue::resetCounters();
+    auto copy = bst;
+
+    CHECK(copy == bst);
+    CHECK(CountedValue::copies == 4);
+    CHECK(CountedValue::defaultConstructions == 0);
+}
+
 class SampleBst {
 public:
     
@@ -171,4 +253,834 @@ TEST_CASE("BinarySearchTree::Iterator can be used to iterate all values stored i
     }
 
     CHECK(vit == sample.values.end()); // Ensure there are no more values in the tree
-}
\ No newline at end of file
+}
+
+TEST_CASE("BinarySearchTree::Iterator has the element type of the tree", "[tree]")
+{
+    BinarySearchTree<std::string> bst;
+    bst.insert("kiwi");
+    bst.insert("apple");
+
+    auto it = bst.beginIterator();
+    static_assert(std::is_same_v<decltype(*it), std::string&>);
+    CHECK(it->size() == 5);
+    CHECK(*++it == "kiwi");
+}
+
+TEST_CASE("BinarySearchTree works with PoolNodeAllocator", "[tree]")
+{
+    BinarySearchTree<int, PoolNodeAllocator<int>> bst;
+    std::vector<int> values{40, 20, 60, 10, 30, 50, 70};
+
+    for(int value : values)
+        bst.insert(value);
+
+    CHECK(bst.allocator().allocationsCount() == values.size());
+
+    BinarySearchTree<int, PoolNodeAllocator<int>> copy(bst);
+    CHECK(copy == bst);
+
+    for(int value : values) {
+        bst.erase(value);
+        CHECK_FALSE(bst.contains(value));
+        CHECK(copy.contains(value));
+    }
+
+    CHECK(bst.allocator().allocationsCount() == 0);
+}
+
+TEST_CASE("BinarySearchTree::compact() moves the nodes next to each other and frees unused memory", "[tree]")
+{
+    BinarySearchTree<int, PoolNodeAllocator<int>> bst;
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<int> distribution(0, 1'000'000);
+    std::vector<int> values;
+
+    for(int i = 0; i < 1000; ++i) {
+        values.push_back(distribution(generator));
+        bst.insert(values.back());
+    }
+    for(int i = 0; i < 900; ++i)
+        bst.erase(values[i]);
+
+    BinarySearchTree<int, PoolNodeAllocator<int>> copy(bst);
+    REQUIRE(bst.allocator().capacityCount() >= 1000);
+
+    bst.compact();
+
+    CHECK(bst == copy); // Same values and shape
+    CHECK(bst.size() == 100);
+    CHECK(bst.allocator().allocationsCount() == 100);
+    CHECK(bst.allocator().capacityCount() == 100);
+
+    // In-order iteration visits adjacent nodes
+    const int* previous = nullptr;
+    for(auto it = bst.beginIterator(); it != bst.endIterator(); ++it) {
+        if(previous)
+            CHECK(reinterpret_cast<const char*>(&*it) - reinterpret_cast<const char*>(previous) == sizeof(Node<int>));
+        previous = &*it;
+    }
+
+    for(int i = 900; i < 1000; ++i)
+        CHECK(bst.contains(values[i]));
+
+    bst.insert(-1); // The tree can still grow
+    CHECK(bst.contains(-1));
+}
+
+TEST_CASE("BinarySearchTree::compact() does nothing for an empty tree", "[tree]")
+{
+    BinarySearchTree<int, PoolNodeAllocator<int>, IterativeNodeOperations<int>> bst;
+    bst.compact();
+    CHECK(bst.empty());
+}
+
+TEST_CASE("BinarySearchTree works with TrackingNodeAllocator", "[tree]")
+{
+    BinarySearchTree<int, TrackingNodeAllocator<int>> bst;
+
+    for(int value : {40, 20, 60, 10, 30})
+        bst.insert(value);
+
+    bst.erase(20);
+    CHECK(bst.allocator().allocationsCount() == 4);
+    CHECK(bst.allocator().totalAllocationsCount() == 5);
+
+    bst.clear();
+    CHECK(bst.allocator().allocationsCount() == 0);
+}
+
+TEST_CASE("BinarySearchTree::clear() resets an ArenaNodeAllocator instead of releasing nodes one by one", "[tree]")
+{
+    BinarySearchTree<int, ArenaNodeAllocator<int>> bst;
+
+    for(int value : {40, 20, 60, 10, 30})
+        bst.insert(value);
+
+    bst.erase(20);
+    CHECK(bst.allocator().totalAllocationsCount() == 5); // Erasing does not reclaim memory
+    CHECK_FALSE(bst.contains(20));
+
+    bst.clear();
+    CHECK(bst.empty());
+    CHECK(bst.allocator().totalAllocationsCount() == 0);
+
+    bst.insert(1);
+    CHECK(bst.contains(1));
+
+    BinarySearchTree<int, ArenaNodeAllocator<int>> copy(bst);
+    CHECK(copy == bst);
+}
+
+/// Inserts random values in a tree, then repeatedly erases one value and inserts another
+template <typename Bst>
+size_t runInsertEraseChurn(size_t size, size_t steps)
+{
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> distribution;
+    std::vector<int> values(size);
+    Bst bst;
+
+    for(int& value : values) {
+        value = distribution(generator);
+        bst.insert(value);
+    }
+
+    for(size_t i = 0; i < steps; ++i) {
+        int& victim = values[i % size];
+        bst.erase(victim);
+        victim = distribution(generator);
+        bst.insert(victim);
+    }
+
+    return bst.size();
+}
+
+using BulkLoadTreeTypes = std::tuple<
+    DebugBst,
+    BinarySearchTree<int, PoolNodeAllocator<int>, IterativeNodeOperations<int>>,
+    BinarySearchTree<int, ArenaNodeAllocator<int>>,
+    BinarySearchTree<int, PoolAllocator<AvlNode<int>>, AvlNodeOperations<int>>,
+    BinarySearchTree<int, IndexNodeAllocator<int>, IterativeNodeOperations<int, IndexNode<int>>>
+>;
+
+TEMPLATE_LIST_TEST_CASE("BinarySearchTree::assignSorted() replaces the contents of the tree", "[tree]", BulkLoadTreeTypes)
+{
+    TestType bst;
+    bst.insert(-1);
+    bst.insert(1000);
+
+    std::vector<int> values(1000);
+    for(int i = 0; i < 1000; ++i)
+        values[i] = i / 2; // With duplicates
+
+    bst.assignSorted(values.begin(), values.end());
+
+    CHECK(bst.size() == values.size());
+    CHECK_FALSE(bst.contains(-1));
+    CHECK_FALSE(bst.contains(1000));
+
+    std::vector<int> visited;
+    for(auto it = bst.beginIterator(); it != bst.endIterator(); ++it)
+        visited.push_back(*it);
+    CHECK(visited == values);
+
+    // The tree remains usable
+    bst.insert(2000);
+    bst.erase(0);
+    CHECK(bst.contains(2000));
+    CHECK(bst.contains(0)); // 0 was there twice
+    CHECK(bst.size() == values.size());
+
+    bst.assignSorted(values.end(), values.end());
+    CHECK(bst.empty());
+}
+
+TEST_CASE("BinarySearchTree::assignSorted() allocates exactly one node per value", "[tree]")
+{
+    DebugBst bst;
+    const std::vector<int> values{1, 2, 3, 5, 8, 13};
+
+    bst.insert(100);
+    bst.assignSorted(values.begin(), values.end());
+
+    CHECK(bst.allocator().allocationsCount() == values.size());
+    CHECK(bst.allocator().totalAllocationsCount() == values.size() + 1);
+}
+
+TEST_CASE("BinarySearchTree::assign() accepts values in any order", "[tree]")
+{
+    BinarySearchTree<std::string, PoolNodeAllocator<std::string>, IterativeNodeOperations<std::string>> bst;
+    const std::vector<std::string> values{"pear", "apple", "fig", "kiwi", "apple"};
+
+    bst.assign(values.begin(), values.end());
+
+    CHECK(bst.size() == values.size());
+    for(const std::string& value : values)
+        CHECK(bst.contains(value));
+}
+
+TEMPLATE_LIST_TEST_CASE("BinarySearchTree::insertBatch() and eraseBatch() work for small and large batches", "[tree]", BulkLoadTreeTypes)
+{
+    std::mt19937 generator(42);
+    std::vector<int> values(8000);
+    std::iota(values.begin(), values.end(), 0);
+    std::shuffle(values.begin(), values.end(), generator);
+    auto next = values.begin();
+
+    TestType bst;
+    std::set<int> expected;
+
+    // Batches much smaller than the tree are applied one value at a time,
+    // larger ones rebuild the tree
+    for(size_t batchSize : {2000, 10, 500, 1, 3000, 0, 50}) {
+        std::vector<int> batch(next, next + batchSize);
+        next += batchSize;
+
+        bst.insertBatch(batch.begin(), batch.end());
+        expected.insert(batch.begin(), batch.end());
+        REQUIRE(bst.size() == expected.size());
+
+        // Erase some of the values in the tree and some, which are not in it
+        std::uniform_int_distribution<int> distribution(0, 8000);
+        for(int& value : batch)
+            value = distribution(generator);
+        std::sort(batch.begin(), batch.end());
+        batch.erase(std::unique(batch.begin(), batch.end()), batch.end());
+
+        bst.eraseBatch(batch.begin(), batch.end());
+        for(int value : batch)
+            expected.erase(value);
+        REQUIRE(bst.size() == expected.size());
+
+        std::vector<int> visited;
+        for(auto it = bst.beginIterator(); it != bst.endIterator(); ++it)
+            visited.push_back(*it);
+        REQUIRE(visited == std::vector<int>(expected.begin(), expected.end()));
+    }
+}
+
+TEST_CASE("BinarySearchTree::eraseBatch() releases the erased nodes", "[tree]")
+{
+    DebugBst bst;
+    const std::vector<int> values{5, 1, 4, 2, 3, 6};
+    const std::vector<int> erased{3, 1, 7, 6};
+
+    bst.insertBatch(values.begin(), values.end());
+    CHECK(bst.allocator().allocationsCount() == 6);
+
+    bst.eraseBatch(erased.begin(), erased.end());
+    CHECK(bst.size() == 3);
+    CHECK(bst.allocator().allocationsCount() == 3);
+    CHECK_FALSE(bst.contains(1));
+    CHECK_FALSE(bst.contains(3));
+    CHECK(bst.contains(2));
+}
+
+/// Fills a tree with the multiples of `step` in [0, limit) and returns them
+template <typename Bst>
+static std::set<int> fillWithMultiples(Bst& bst, int step, int limit)
+{
+    std::set<int> values;
+    std::vector<int> shuffled;
+    for(int value = 0; value < limit; value += step)
+        shuffled.push_back(value);
+
+    std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(step));
+    for(int value : shuffled)
+        bst.insert(value);
+
+    return std::set<int>(shuffled.begin(), shuffled.end());
+}
+
+template <typename Bst>
+static std::vector<int> valuesOf(Bst& bst)
+{
+    std::vector<int> values;
+    for(auto it = bst.beginIterator(); it != bst.endIterator(); ++it)
+        values.push_back(*it);
+    return values;
+}
+
+TEMPLATE_LIST_TEST_CASE("BinarySearchTree::unionWith(), intersect() and difference() work like the std set algorithms", "[tree]", BulkLoadTreeTypes)
+{
+    const unsigned threads = GENERATE(1, 4);
+    const int step = GENERATE(1, 3, 50);
+    WorkStealingPool pool(threads);
+
+    TestType bst, other;
+    const std::set<int> a = fillWithMultiples(bst, 2, 3000);
+    const std::set<int> b = fillWithMultiples(other, step, 1000 * step);
+    std::vector<int> expected;
+
+    SECTION("unionWith()") {
+        std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+        bst.unionWith(other, pool);
+    }
+    SECTION("intersect()") {
+        std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+        bst.intersect(other, pool);
+    }
+    SECTION("difference()") {
+        std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+        bst.difference(other, pool);
+    }
+
+    CHECK(bst.size() == expected.size());
+    CHECK(valuesOf(bst) == expected);
+    CHECK(valuesOf(other) == std::vector<int>(b.begin(), b.end()));
+}
+
+TEST_CASE("BinarySearchTree set operations reuse and release nodes", "[tree]")
+{
+    DebugBst bst, other;
+    fillWithMultiples(bst, 2, 100);   // 50 values
+    fillWithMultiples(other, 5, 100); // 20 values, 10 of them in bst
+
+    SECTION("unionWith() keeps one node for each value") {
+        bst.unionWith(other);
+        CHECK(bst.size() == 60);
+        CHECK(bst.allocator().allocationsCount() == 60);
+    }
+    SECTION("intersect() allocates nothing") {
+        bst.intersect(other);
+        CHECK(bst.size() == 10);
+        CHECK(bst.allocator().allocationsCount() == 10);
+    }
+    SECTION("difference() allocates nothing") {
+        bst.difference(other);
+        CHECK(bst.size() == 40);
+        CHECK(bst.allocator().allocationsCount() == 40);
+    }
+    SECTION("Operations with the tree itself") {
+        bst.unionWith(bst);
+        CHECK(bst.size() == 50);
+        bst.intersect(bst);
+        CHECK(bst.size() == 50);
+        bst.difference(bst);
+        CHECK(bst.empty());
+        CHECK(bst.allocator().allocationsCount() == 0);
+    }
+
+    CHECK(other.allocator().allocationsCount() == 20);
+}
+
+TEMPLATE_LIST_TEST_CASE("BinarySearchTree::lowerBound(), upperBound() and equalRange() find the bounds of a value", "[tree]", BulkLoadTreeTypes)
+{
+    TestType bst;
+    std::vector<int> values(100);
+    for(int i = 0; i < 100; ++i)
+        values[i] = 3 * i; // 0, 3, ..., 297
+    std::shuffle(values.begin(), values.end(), std::mt19937(42));
+
+    for(int value : values)
+        bst.insert(value);
+
+    for(int value = -2; value < 302; ++value) {
+        const int lower = std::max(0, (value + 2) / 3 * 3);
+        const int upper = std::max(0, (value + 3) / 3 * 3);
+
+        auto it = bst.lowerBound(value);
+        if(lower < 300)
+            REQUIRE(*it == lower);
+        else
+            REQUIRE(it == bst.endIterator());
+
+        it = bst.upperBound(value);
+        if(upper < 300)
+            REQUIRE(*it == upper);
+        else
+            REQUIRE(it == bst.endIterator());
+    }
+
+    auto [first, last] = bst.equalRange(30);
+    CHECK(*first == 30);
+    CHECK(*last == 33);
+    CHECK(++first == last);
+
+    auto [begin, end] = bst.equalRange(31);
+    CHECK(begin == end);
+
+    // Iterating from a lower bound visits all larger values
+    int expected = 150;
+    for(auto i = bst.lowerBound(149); i != bst.endIterator(); ++i, expected += 3)
+        REQUIRE(*i == expected);
+    CHECK(expected == 300);
+}
+
+TEMPLATE_LIST_TEST_CASE("BinarySearchTree::forEachInRange() visits the values in a range in sorted order", "[tree]", BulkLoadTreeTypes)
+{
+    TestType bst;
+    std::vector<int> values(200);
+    std::iota(values.begin(), values.end(), 0);
+    std::shuffle(values.begin(), values.end(), std::mt19937(7));
+
+    for(int value : values)
+        bst.insert(value);
+
+    std::vector<int> visited;
+    auto collect = [&visited](const int& value) { visited.push_back(value); };
+
+    SECTION("Range inside the tree") {
+        bst.forEachInRange(50, 59, collect);
+        CHECK(visited == std::vector<int>{50, 51, 52, 53, 54, 55, 56, 57, 58, 59});
+    }
+    SECTION("Range covering the whole tree") {
+        bst.forEachInRange(-100, 1000, collect);
+        std::sort(values.begin(), values.end());
+        CHECK(visited == values);
+    }
+    SECTION("Empty ranges") {
+        bst.forEachInRange(300, 400, collect);
+        bst.forEachInRange(10, 5, collect);
+        CHECK(visited.empty());
+    }
+}
+
+/// Node allocator, which fails with std::bad_alloc after a given number of allocations
+class LimitedNodeAllocator : public DebugNodeAllocator<int> {
+public:
+    static inline size_t remaining = 0;
+
+    template <typename... Args>
+    Node<int>* buy(Args&&... args)
+    {
+        if(remaining == 0)
+            throw std::bad_alloc();
+
+        --remaining;
+        return DebugNodeAllocator<int>::buy(std::forward<Args>(args)...);
+    }
+};
+
+TEST_CASE("BinarySearchTree::insertBatch() leaves the tree unchanged when allocation fails", "[tree]")
+{
+    BinarySearchTree<int, LimitedNodeAllocator, IterativeNodeOperations<int>> bst;
+    LimitedNodeAllocator::remaining = 2;
+    bst.insert(10);
+    bst.insert(20);
+
+    const std::vector<int> values{1, 2, 3, 4, 5};
+    LimitedNodeAllocator::remaining = 3;
+
+    CHECK_THROWS_AS(bst.insertBatch(values.begin(), values.end()), std::bad_alloc);
+    CHECK(bst.size() == 2);
+    CHECK_FALSE(bst.contains(1));
+    CHECK(bst.allocator().allocationsCount() == 2);
+}
+
+TEST_CASE("BinarySearchTree::assignSorted() leaves the tree unchanged when allocation fails", "[tree]")
+{
+    BinarySearchTree<int, LimitedNodeAllocator, IterativeNodeOperations<int>> bst;
+    LimitedNodeAllocator::remaining = 2;
+    bst.insert(10);
+    bst.insert(20);
+
+    const std::vector<int> values{1, 2, 3, 4, 5};
+    LimitedNodeAllocator::remaining = 3;
+
+    CHECK_THROWS_AS(bst.assignSorted(values.begin(), values.end()), std::bad_alloc);
+    CHECK(bst.size() == 2);
+    CHECK(bst.contains(10));
+    CHECK(bst.contains(20));
+    CHECK(bst.allocator().allocationsCount() == 2);
+}
+
+//
+// This test is hidden. Run it explicitly with: unit-tests "[benchmark]"
+//
+TEST_CASE("Insert/erase churn with different node allocators", "[.][benchmark]")
+{
+    const size_t size = 100'000;
+    const size_t steps = 200'000;
+
+    BENCHMARK("SimpleNodeAllocator")
+    {
+        return runInsertEraseChurn<BinarySearchTree<int, SimpleNodeAllocator<int>>>(size, steps);
+    };
+
+    BENCHMARK("PoolNodeAllocator")
+    {
+        return runInsertEraseChurn<BinarySearchTree<int, PoolNodeAllocator<int>>>(size, steps);
+    };
+
+    BENCHMARK("DebugNodeAllocator")
+    {
+        return runInsertEraseChurn<BinarySearchTree<int, DebugNodeAllocator<int>>>(size, steps);
+    };
+
+    BENCHMARK("TrackingNodeAllocator")
+    {
+        return runInsertEraseChurn<BinarySearchTree<int, TrackingNodeAllocator<int>>>(size, steps);
+    };
+}
+
+/// Builds a tree from random values, queries it and then destroys it
+template <typename Bst>
+size_t buildQueryDiscard(size_t size)
+{
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> distribution;
+    Bst bst;
+
+    for(size_t i = 0; i < size; ++i)
+        bst.insert(distribution(generator));
+
+    return bst.contains(distribution(generator)) + bst.size();
+}
+
+//
+// This test is hidden. Run it explicitly with: unit-tests "[benchmark]"
+//
+TEST_CASE("Build and discard a tree with different allocators", "[.][benchmark]")
+{
+    const size_t size = 100'000;
+
+    BENCHMARK("SimpleNodeAllocator")
+    {
+        return buildQueryDiscard<BinarySearchTree<int, SimpleNodeAllocator<int>>>(size);
+    };
+
+    BENCHMARK("PoolNodeAllocator")
+    {
+        return buildQueryDiscard<BinarySearchTree<int, PoolNodeAllocator<int>>>(size);
+    };
+
+    BENCHMARK("ArenaNodeAllocator")
+    {
+        return buildQueryDiscard<BinarySearchTree<int, ArenaNodeAllocator<int>>>(size);
+    };
+}
+
+/// Runs insert/erase churn on one tree per thread and returns the elapsed time in seconds
+template <typename Bst>
+double runChurnOnThreads(size_t threadCount, size_t size, size_t steps)
+{
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+
+    for(size_t i = 0; i < threadCount; ++i)
+        threads.emplace_back([=] { runInsertEraseChurn<Bst>(size, steps); });
+
+    for(std::thread& thread : threads)
+        thread.join();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+//
+// This test is hidden. Run it explicitly with: unit-tests "[benchmark]"
+//
+TEST_CASE("Insert/erase churn on one tree per thread", "[.][benchmark]")
+{
+    const size_t threadCount = GENERATE(1, 2, 4, 8, 16, 32);
+    const size_t size = 20'000;
+    const size_t steps = 100'000;
+    const double operations = 2.0 * threadCount * (size + steps);
+
+    const double simple = runChurnOnThreads<BinarySearchTree<int, SimpleNodeAllocator<int>>>(threadCount, size, steps);
+    const double caching = runChurnOnThreads<BinarySearchTree<int, ThreadCachingNodeAllocator<int>>>(threadCount, size, steps);
+
+    WARN(threadCount << " threads: "
+        << "SimpleNodeAllocator " << (operations / simple / 1e6) << " M ops/s, "
+        << "ThreadCachingNodeAllocator " << (operations / caching / 1e6) << " M ops/s");
+}
+
+//
+// This test is hidden. Run it explicitly with: unit-tests "[benchmark]"
+//
+TEST_CASE("Lookup and iteration before and after BinarySearchTree::compact()", "[.][benchmark]")
+{
+    const size_t size = 1'000'000;
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> distribution;
+    std::vector<int> values(size);
+
+    // Churn scatters the nodes across the slabs of the allocator
+    BinarySearchTree<int, PoolNodeAllocator<int>> bst;
+    for(int& value : values) {
+        value = distribution(generator);
+        bst.insert(value);
+    }
+    for(size_t i = 0; i < size; ++i) {
+        bst.erase(values[i]);
+        values[i] = distribution(generator);
+        bst.insert(values[i]);
+    }
+    std::shuffle(values.begin(), values.end(), generator);
+
+    auto lookup = [&] {
+        size_t found = 0;
+        for(size_t i = 0; i < 100'000; ++i)
+            found += bst.contains(values[i]);
+        return found;
+    };
+
+    auto iterate = [&] {
+        long long total = 0;
+        for(auto it = bst.beginIterator(); it != bst.endIterator(); ++it)
+            total += *it;
+        return total;
+    };
+
+    BENCHMARK("contains() before compaction") { return lookup(); };
+    BENCHMARK("iteration before compaction") { return iterate(); };
+
+    bst.compact();
+
+    BENCHMARK("contains() after compaction") { return lookup(); };
+    BENCHMARK("iteration after compaction") { return iterate(); };
+}
+
+//
+// This test is hidden. Run it explicitly with: unit-tests "[benchmark]"
+//
+TEST_CASE("Loading sorted values with insert() and assignSorted()", "[.][benchmark]")
+{
+    const int size = 1'000'000;
+    std::vector<int> values(size);
+    for(int i = 0; i < size; ++i)
+        values[i] = i;
+
+    BENCHMARK("AVL tree, insert() one by one")
+    {
+        BinarySearchTree<int, PoolAllocator<AvlNode<int>>, AvlNodeOperations<int>> bst;
+        for(int value : values)
+            bst.insert(value);
+        return bst.size();
+    };
+
+    BENCHMARK("AVL tree, assignSorted()")
+    {
+        BinarySearchTree<int, PoolAllocator<AvlNode<int>>, AvlNodeOperations<int>> bst;
+        bst.assignSorted(values.begin(), values.end());
+        return bst.size();
+    };
+
+    BENCHMARK("SimpleNodeAllocator, assignSorted()")
+    {
+        BinarySearchTree<int, SimpleNodeAllocator<int>, IterativeNodeOperations<int>> bst;
+        bst.assignSorted(values.begin(), values.end());
+        return bst.size();
+    };
+
+    BENCHMARK("PoolNodeAllocator, assignSorted()")
+    {
+        BinarySearchTree<int, PoolNodeAllocator<int>, IterativeNodeOperations<int>> bst;
+        bst.assignSorted(values.begin(), values.end());
+        return bst.size();
+    };
+}
+
+/// Builds a tree of `treeSize` distinct values, then inserts and erases `batchSize` other values
+/// with insert()/erase() one by one and with insertBatch()/eraseBatch(). Returns the times in seconds.
+template <typename Bst>
+std::array<double, 4> insertAndEraseBatch(size_t treeSize, size_t batchSize)
+{
+    std::mt19937 generator(42);
+    std::vector<int> values(treeSize + batchSize);
+    std::iota(values.begin(), values.end(), 0);
+    std::shuffle(values.begin(), values.end(), generator);
+
+    const std::vector<int> batch(values.begin() + treeSize, values.end());
+    values.resize(treeSize);
+
+    std::array<double, 4> times;
+    auto measure = [](auto&& operation) {
+        auto start = std::chrono::steady_clock::now();
+        operation();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    Bst single, batched;
+    single.assign(values.begin(), values.end());
+    batched.assign(values.begin(), values.end());
+
+    times[0] = measure([&] { for(int value : batch) single.insert(value); });
+    times[1] = measure([&] { batched.insertBatch(batch.begin(), batch.end()); });
+    times[2] = measure([&] { for(int value : batch) single.erase(value); });
+    times[3] = measure([&] { batched.eraseBatch(batch.begin(), batch.end()); });
+
+    CHECK(single.size() == treeSize);
+    CHECK(batched.size() == treeSize);
+    return times;
+}
+
+//
+// This test is hidden. Run it explicitly with: unit-tests "[benchmark]"
+//
+TEST_CASE("Inserting and erasing batches of different sizes", "[.][benchmark]")
+{
+    const size_t treeSize = 1'000'000;
+    const size_t batchSize = GENERATE(1'000, 10'000, 100'000, 1'000'000);
+
+    auto times = insertAndEraseBatch<BinarySearchTree<int, PoolAllocator<AvlNode<int>>, AvlNodeOperations<int>>>(treeSize, batchSize);
+
+    WARN("AVL tree of " << treeSize << " values, batch of " << batchSize << ": "
+        << "insert() " << times[0] * 1000 << " ms, insertBatch() " << times[1] * 1000 << " ms, "
+        << "erase() " << times[2] * 1000 << " ms, eraseBatch() " << times[3] * 1000 << " ms");
+}
+
+//
+// This test is hidden. Run it explicitly with: unit-tests "[benchmark]"
+//
+TEST_CASE("Set operations on trees of different sizes", "[.][benchmark]")
+{
+    using AvlBst = BinarySearchTree<int, PoolAllocator<AvlNode<int>>, AvlNodeOperations<int>>;
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    const int size = 1'000'000;
+    const int otherSize = GENERATE(1'000, 100'000, 1'000'000);
+    const unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    WorkStealingPool pool(threads);
+
+    // Distinct values from [0, 2 * size), so that about half of the other values are in the large tree
+    std::mt19937 generator(42);
+    std::vector<int> values(2 * size);
+    std::iota(values.begin(), values.end(), 0);
+    std::shuffle(values.begin(), values.end(), generator);
+    const std::vector<int> otherValues(values.begin(), values.begin() + otherSize);
+    std::shuffle(values.begin(), values.end(), generator);
+    values.resize(size);
+
+    AvlBst large, small;
+    large.assign(values.begin(), values.end());
+    small.assign(otherValues.begin(), otherValues.end());
+
+    auto measure = [](AvlBst& bst, auto&& operation) {
+        auto start = std::chrono::steady_clock::now();
+        operation(bst);
+        return Milliseconds(std::chrono::steady_clock::now() - start).count();
+    };
+
+    // The smaller tree is intersected with the large one, the large one is united with the smaller one
+    AvlBst lookups = small, sequential = small, parallel = small;
+    const double intersectByLookups = measure(lookups, [&](AvlBst& bst) {
+        for(int value : otherValues)
+            if( ! large.contains(value) )
+                bst.erase(value);
+    });
+    const double intersectSequential = measure(sequential, [&](AvlBst& bst) { bst.intersect(large); });
+    const double intersectParallel = measure(parallel, [&](AvlBst& bst) { bst.intersect(large, pool); });
+
+    CHECK(sequential.size() == lookups.size());
+    CHECK(parallel.size() == lookups.size());
+
+    lookups = large;
+    sequential = large;
+    parallel = large;
+    const double unionByLookups = measure(lookups, [&](AvlBst& bst) {
+        for(int value : otherValues)
+            if( ! bst.contains(value) )
+                bst.insert(value);
+    });
+    const double unionSequential = measure(sequential, [&](AvlBst& bst) { bst.unionWith(small); });
+    const double unionParallel = measure(parallel, [&](AvlBst& bst) { bst.unionWith(small, pool); });
+
+    CHECK(sequential.size() == lookups.size());
+    CHECK(parallel.size() == lookups.size());
+
+    WARN("Trees of " << otherSize << " and " << size << " values on " << threads << " threads: "
+        << "intersect by lookups " << intersectByLookups << " ms, intersect() " << intersectSequential
+        << " ms, parallel " << intersectParallel << " ms; union by lookups " << unionByLookups
+        << " ms, unionWith() " << unionSequential << " ms, parallel " << unionParallel << " ms");
+}
+
+//
+// This test is hidden. Run it explicitly with: unit-tests "[benchmark]"
+//
+TEST_CASE("Scanning ranges from the beginning, from lowerBound() and with forEachInRange()", "[.][benchmark]")
+{
+    using AvlBst = BinarySearchTree<int, PoolAllocator<AvlNode<int>>, AvlNodeOperations<int>>;
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    const int size = 1'000'000;
+    const int width = GENERATE(10, 1000, 100'000);
+    const int queries = 100;
+
+    std::vector<int> values(size);
+    std::iota(values.begin(), values.end(), 0);
+    AvlBst bst;
+    bst.assign(values.begin(), values.end());
+
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> distribution(0, size - width);
+    std::vector<int> starts(queries);
+    for(int& start : starts)
+        start = distribution(generator);
+
+    auto measure = [&](auto&& sumRange) {
+        long long sum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for(int lo : starts)
+            sum += sumRange(lo, lo + width - 1);
+        return std::make_pair(sum, Milliseconds(std::chrono::steady_clock::now() - start).count());
+    };
+
+    auto fromBeginning = measure([&](int lo, int hi) {
+        long long sum = 0;
+        for(auto it = bst.beginIterator(); it != bst.endIterator() && *it <= hi; ++it)
+            if(*it >= lo)
+                sum += *it;
+        return sum;
+    });
+    auto fromLowerBound = measure([&](int lo, int hi) {
+        long long sum = 0;
+        for(auto it = bst.lowerBound(lo); it != bst.endIterator() && *it <= hi; ++it)
+            sum += *it;
+        return sum;
+    });
+    auto visitor = measure([&](int lo, int hi) {
+        long long sum = 0;
+        bst.forEachInRange(lo, hi, [&sum](int value) { sum += value; });
+        return sum;
+    });
+
+    CHECK(fromLowerBound.first == fromBeginning.first);
+    CHECK(visitor.first == fromBeginning.first);
+
+    WARN(queries << " ranges of " << width << " values in a tree of " << size << " values: "
+        << "iterating from the beginning " << fromBeginning.second << " ms, from lowerBound() "
+        << fromLowerBound.second << " ms, forEachInRange() " << visitor.second << " ms");
+}
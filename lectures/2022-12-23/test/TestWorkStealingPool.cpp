@@ -0,0 +1,86 @@
+#include "catch2/catch_all.hpp"
+#include "WorkStealingPool.h"
+
+#include <atomic>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
+/// Computes Fibonacci numbers the slow way, forking on both recursive calls
+static long long fibonacci(WorkStealingPool& pool, int n)
+{
+    if(n < 2)
+        return n;
+
+    long long a = 0;
+    long long b = 0;
+    pool.forkJoin([&] { a = fibonacci(pool, n - 1); }, [&] { b = fibonacci(pool, n - 2); });
+    return a + b;
+}
+
+TEST_CASE("WorkStealingPool::run() executes nested fork-join tasks", "[pool]")
+{
+    const unsigned threads = GENERATE(1, 2, 4);
+    WorkStealingPool pool(threads);
+    CHECK(pool.threadCount() == threads);
+
+    long long result = 0;
+    pool.run([&] { result = fibonacci(pool, 20); });
+    CHECK(result == 6765);
+}
+
+TEST_CASE("WorkStealingPool::forkJoin() runs both functions outside run()", "[pool]")
+{
+    WorkStealingPool pool(2);
+    CHECK(fibonacci(pool, 15) == 610);
+}
+
+TEST_CASE("WorkStealingPool spreads tasks over its threads", "[pool]")
+{
+    WorkStealingPool pool(4);
+    std::mutex mutex;
+    std::set<std::thread::id> ids;
+    std::atomic<int> running{0};
+
+    // Every leaf waits until all four are running, which needs four threads
+    auto leaf = [&] {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ids.insert(std::this_thread::get_id());
+        }
+        ++running;
+        while(running.load() < 4)
+            std::this_thread::yield();
+    };
+
+    pool.run([&] {
+        pool.forkJoin(
+            [&] { pool.forkJoin(leaf, leaf); },
+            [&] { pool.forkJoin(leaf, leaf); });
+    });
+
+    CHECK(ids.size() == 4);
+    CHECK(ids.count(std::this_thread::get_id()) == 0);
+}
+
+TEST_CASE("WorkStealingPool passes exceptions to the caller after all tasks are complete", "[pool]")
+{
+    WorkStealingPool pool(2);
+    std::atomic<int> completed{0};
+
+    auto run = [&] {
+        pool.run([&] {
+            pool.forkJoin(
+                [&] { throw std::runtime_error("first"); },
+                [&] { ++completed; });
+        });
+    };
+
+    CHECK_THROWS_AS(run(), std::runtime_error);
+    CHECK(completed == 1);
+
+    // The pool can be used after an exception
+    long long result = 0;
+    pool.run([&] { result = fibonacci(pool, 10); });
+    CHECK(result == 55);
+}